@@ -0,0 +1,50 @@
+// asset_archive.cpp
+#include "asset_archive.hpp"
+
+#include <cstring>
+
+//------------------------------------------------------------------------------
+// open / close: map the whole file read-only
+//------------------------------------------------------------------------------
+bool AssetArchive::open(const std::string &path)
+{
+    close();
+    if (!file_.open(path)) return false;
+    const std::size_t size = file_.size();
+
+    // ----------------------------------------------------------------------
+    // Validate header and every index entry before anyone dereferences them
+    // ----------------------------------------------------------------------
+    bool valid = size >= sizeof(ArchiveHeader)
+              && header().magic == ArchiveMagic
+              && header().version == ArchiveVersion
+              && sizeof(ArchiveHeader) + std::size_t(header().entryCount) * sizeof(ArchiveEntry) <= size;
+
+    for (std::uint32_t i = 0; valid && i < header().entryCount; i++) {
+        const ArchiveEntry &e = entry(i);
+        valid = std::size_t(e.offset) + e.size <= size
+             && std::memchr(e.name, '\0', ArchiveNameSize) != nullptr;
+    }
+
+    if (!valid) close();
+    return valid;
+}
+
+void AssetArchive::close()
+{
+    file_.close();
+}
+
+//------------------------------------------------------------------------------
+// Lookup (load time only, a few dozen entries → linear scan is fine)
+//------------------------------------------------------------------------------
+const ArchiveEntry* AssetArchive::find(std::string_view name, ArchiveEntryType type) const
+{
+    if (!isOpen()) return nullptr;
+
+    for (std::uint32_t i = 0; i < header().entryCount; i++) {
+        const ArchiveEntry &e = entry(i);
+        if (e.type == type && name == e.name) return &e;
+    }
+    return nullptr;
+}
@@ -0,0 +1,92 @@
+#ifndef _ASSET_ARCHIVE_H_
+#define _ASSET_ARCHIVE_H_
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "mapped_file.hpp"
+
+//------------------------------------------------------------------------------
+// Packed asset archive (assets/kungfu.pak).
+//
+// Built offline by tools/asset_packer.cpp from spritesList/soundsList/
+// musicsList only, so unreferenced files never ship. Payloads are stored
+// ready to upload: RGBA8 pixels for images, raw PCM for sound effects. Music
+// stays encoded because it is streamed. At runtime the file is mapped
+// read-only and textures/sounds are created straight from the mapping.
+//
+// Layout (little-endian):
+//   ArchiveHeader
+//   ArchiveEntry[entryCount]
+//   payloads, each aligned to ArchiveAlignment
+//------------------------------------------------------------------------------
+constexpr char          ArchiveFile[]    = "kungfu.pak";
+constexpr std::uint32_t ArchiveMagic     = 0x4B50464B;  ///< "KFPK"
+constexpr std::uint32_t ArchiveVersion   = 1;
+constexpr std::uint32_t ArchiveAlignment = 64;          ///< cache line, SIMD friendly
+constexpr std::size_t   ArchiveNameSize  = 48;
+
+enum class ArchiveEntryType : std::uint32_t {
+    Image = 1,  ///< params: width, height (RGBA8, tightly packed)
+    Wave  = 2,  ///< params: frameCount, sampleRate, sampleSize (bits), channels
+    Blob  = 3   ///< raw bytes (encoded music, text tables)
+};
+
+struct ArchiveHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint32_t reserved;
+};
+
+struct ArchiveEntry {
+    char             name[ArchiveNameSize];  ///< e.g. "images/bg_dojo", NUL padded
+    ArchiveEntryType type;
+    std::uint32_t    offset;                 ///< from start of file
+    std::uint32_t    size;                   ///< payload bytes
+    std::uint32_t    params[4];
+};
+
+static_assert(sizeof(ArchiveHeader) == 16, "archive header layout");
+static_assert(sizeof(ArchiveEntry)  == 76, "archive entry layout");
+
+//------------------------------------------------------------------------------
+// AssetArchive: read-only memory mapping of a .pak file
+//------------------------------------------------------------------------------
+class AssetArchive {
+public:
+    AssetArchive() = default;
+    ~AssetArchive() { close(); }
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    /// Map `path` and validate its header and index. False if missing/invalid.
+    bool open(const std::string &path);
+    void close();
+    inline bool isOpen() const { return file_.isOpen(); }
+
+    /// Entry by name and type, or nullptr
+    const ArchiveEntry* find(std::string_view name, ArchiveEntryType type) const;
+
+    /// Pointer to an entry's payload inside the mapping
+    inline const std::uint8_t* data(const ArchiveEntry &entry) const { return base() + entry.offset; }
+
+    inline std::uint32_t       entryCount() const { return header().entryCount; }
+    inline const ArchiveEntry& entry(std::uint32_t index) const {
+        return reinterpret_cast<const ArchiveEntry*>(base() + sizeof(ArchiveHeader))[index];
+    }
+
+private:
+    inline const ArchiveHeader& header() const {
+        return *reinterpret_cast<const ArchiveHeader*>(base());
+    }
+    inline const std::uint8_t* base() const { return file_.data(); }
+
+    MappedFile file_;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef _ASSET_IDS_H_
+#define _ASSET_IDS_H_
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+// Asset lists. Each entry is the file name without extension (sprites also
+// carry their horizontal frame count); the lists are expanded into enums (for
+// indexing) and name tables (for loading), so a typo in gameplay code is a
+// compile error instead of an .at() throw mid-game.
+//------------------------------------------------------------------------------
+#define KUNGFU_SPRITES(X)                                                      \
+    /* logos and fonts (font frame count = spriteLetters.size()) */            \
+    X(game_name, 1) X(logo_konami, 1) X(font_symbols, 36)                      \
+    /* backgrounds / icons */                                                  \
+    X(bg_dojo, 1) X(life_icon, 1)                                              \
+    /* HUD elements */                                                         \
+    X(hud_health, 1) X(green_health, 1) X(red_health, 1)                       \
+    /* player states */                                                        \
+    X(player_default, 2) X(player_crouch, 1) X(player_punch_stand, 1)          \
+    X(player_kick_stand, 1) X(player_punch_crouch, 1) X(player_kick_crouch, 1) \
+    X(player_kick_high, 1) X(player_kick_fly, 1) X(player_defeated, 2)         \
+    X(player_smile, 1)                                                         \
+    /* enemy states */                                                         \
+    X(wang_default, 2) X(wang_kick, 2) X(wang_punch, 2) X(wang_hit, 1) X(wang_defeated, 1) \
+    X(tao_default, 2)  X(tao_kick, 2)  X(tao_punch, 2)  X(tao_hit, 1)  X(tao_defeated, 1)  \
+    X(chen_default, 4) X(chen_kick, 2) X(chen_punch, 2) X(chen_hit, 1) X(chen_defeated, 1) \
+    X(lang_default, 2) X(lang_kick, 2) X(lang_punch, 2) X(lang_hit, 1) X(lang_defeated, 1) \
+    X(mu_default, 2)   X(mu_kick, 2)   X(mu_punch, 2)   X(mu_hit, 1)   X(mu_defeated, 1)   \
+    /* effects */                                                              \
+    X(spinning_chain, 8) X(effect_hit, 1)
+
+#define KUNGFU_SOUNDS(X)                                                       \
+    X(attack) X(collision) X(game_over) X(defeated) X(win) X(counting)         \
+    X(health_low) X(twitch_feet) X(collision2)
+
+#define KUNGFU_MUSICS(X)                                                       \
+    X(main_music)
+
+/// Enemies in level order (level 1 = wang)
+#define KUNGFU_ENEMIES(X)                                                      \
+    X(wang) X(tao) X(chen) X(lang) X(mu)
+
+#define KUNGFU_ASSET_ENUM(name)  name,
+#define KUNGFU_ASSET_NAME(name)  #name,
+#define KUNGFU_SPRITE_ENUM(name, frames)    name,
+#define KUNGFU_SPRITE_NAME(name, frames)    #name,
+#define KUNGFU_SPRITE_FRAMES(name, frames)  frames,
+
+enum class SpriteId : int { KUNGFU_SPRITES(KUNGFU_SPRITE_ENUM) Count };
+enum class SoundId  : int { KUNGFU_SOUNDS(KUNGFU_ASSET_ENUM)  Count };
+enum class MusicId  : int { KUNGFU_MUSICS(KUNGFU_ASSET_ENUM)  Count };
+
+constexpr std::size_t SpriteCount = static_cast<std::size_t>(SpriteId::Count);
+constexpr std::size_t SoundCount  = static_cast<std::size_t>(SoundId::Count);
+constexpr std::size_t MusicCount  = static_cast<std::size_t>(MusicId::Count);
+
+// List of all asset names (without extension), indexed by their id
+inline constexpr std::array<const char*, SpriteCount> spritesList = { KUNGFU_SPRITES(KUNGFU_SPRITE_NAME) };
+inline constexpr std::array<const char*, SoundCount>  soundsList  = { KUNGFU_SOUNDS(KUNGFU_ASSET_NAME) };
+inline constexpr std::array<const char*, MusicCount>  musicsList  = { KUNGFU_MUSICS(KUNGFU_ASSET_NAME) };
+
+// How many sub-images (tiles) each sprite sheet is split into horizontally
+inline constexpr std::array<int, SpriteCount> spriteFrameCounts = { KUNGFU_SPRITES(KUNGFU_SPRITE_FRAMES) };
+
+//------------------------------------------------------------------------------
+// Per-enemy sprite handles. EnemyPose order matches the old string table
+// {"kick", "punch", "default", "defeated", "hit"}, so an attack index
+// (0 = kick, 1 = punch) can still be used directly as a pose.
+//------------------------------------------------------------------------------
+enum class EnemyPose : int {
+    Kick     = 0,
+    Punch    = 1,
+    Default  = 2,
+    Defeated = 3,
+    Hit      = 4,
+    Count
+};
+
+constexpr std::size_t EnemyPoseCount = static_cast<std::size_t>(EnemyPose::Count);
+using EnemySpriteSet = std::array<SpriteId, EnemyPoseCount>;
+
+#define KUNGFU_ENEMY_SPRITE_SET(name)                                          \
+    EnemySpriteSet{ SpriteId::name##_kick, SpriteId::name##_punch,             \
+                    SpriteId::name##_default, SpriteId::name##_defeated,       \
+                    SpriteId::name##_hit },
+
+#define KUNGFU_ENEMY_COUNT(name) + 1
+
+constexpr std::size_t EnemyCount = 0 KUNGFU_ENEMIES(KUNGFU_ENEMY_COUNT);
+
+inline constexpr std::array<EnemySpriteSet, EnemyCount> enemySpriteTable = {
+    KUNGFU_ENEMIES(KUNGFU_ENEMY_SPRITE_SET)
+};
+
+#undef KUNGFU_ENEMY_SPRITE_SET
+#undef KUNGFU_ENEMY_COUNT
+
+/// Enemy (level - 1) whose sheet this is, or -1 for shared sprites
+constexpr int enemyOfSprite(SpriteId id)
+{
+    for (std::size_t e = 0; e < EnemyCount; e++)
+        for (SpriteId s : enemySpriteTable[e])
+            if (s == id) return int(e);
+    return -1;
+}
+
+#endif
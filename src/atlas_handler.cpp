@@ -0,0 +1,73 @@
+// atlas_handler.cpp
+#include "atlas_handler.hpp"
+
+#include <fstream>
+#include <sstream>
+
+bool SpriteAtlas::load(const std::string &dir)
+{
+    std::ifstream ifs(dir + IndexFile);
+    if (!ifs) return false; // no atlas built, use loose files
+    return parse(ifs);
+}
+
+bool SpriteAtlas::parse(std::istream &is)
+{
+    pages.clear();
+    regions = {};
+
+    std::string line;
+    while (std::getline(is, line)) {
+        std::istringstream in(line);
+        std::string kind;
+        if (!(in >> kind) || kind[0] == '#') continue;
+
+        if (kind == "page") {
+            size_t index; std::string file;
+            if (!(in >> index >> file)) return false;
+            if (pages.size() <= index) pages.resize(index + 1);
+            pages[index] = file;
+        }
+        else if (kind == "sprite") {
+            std::string name; AtlasRegion r;
+            if (!(in >> name >> r.page >> r.rect.x >> r.rect.y
+                     >> r.rect.width >> r.rect.height >> r.frames)) return false;
+
+            for (size_t i = 0; i < SpriteCount; i++) {
+                if (name == spritesList[i]) { regions[i] = r; break; }
+            }
+        }
+    }
+
+    // Stale atlas (sprite added, frame count changed, page missing) → reject
+    for (size_t i = 0; i < SpriteCount; i++) {
+        const auto &r = regions[i];
+        if (r.page < 0 || size_t(r.page) >= pages.size() || pages[r.page].empty()
+            || r.frames != spriteFrameCounts[i])
+            return false;
+    }
+    return true;
+}
+
+bool SpriteAtlas::save(const std::string &dir) const
+{
+    std::ofstream ofs(dir + IndexFile);
+    if (!ofs) return false;
+    write(ofs);
+    return bool(ofs);
+}
+
+void SpriteAtlas::write(std::ostream &ofs) const
+{
+    ofs << "# kungfu sprite atlas: page <index> <file>\n"
+           "#                      sprite <name> <page> <x> <y> <w> <h> <frames>\n";
+    for (size_t i = 0; i < pages.size(); i++)
+        ofs << "page " << i << ' ' << pages[i] << '\n';
+
+    for (size_t i = 0; i < SpriteCount; i++) {
+        const auto &r = regions[i];
+        ofs << "sprite " << spritesList[i] << ' ' << r.page << ' '
+            << r.rect.x << ' ' << r.rect.y << ' '
+            << r.rect.width << ' ' << r.rect.height << ' ' << r.frames << '\n';
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef _ATLAS_H_
+#define _ATLAS_H_
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <iosfwd>
+
+#include "asset_ids.hpp"
+#include "platform_handler.hpp"
+
+//------------------------------------------------------------------------------
+// Sprite atlas region table.
+//
+// tools/atlas_packer.cpp packs every sprite in spritesList into one or a few
+// atlas pages and writes this table next to them; at runtime Game loads the
+// pages once and every Sprite draws a sub-rect of a shared texture, so a
+// whole frame stays in one draw batch.
+//
+// On disk (atlas.idx, plain text, one record per line):
+//   page   <index> <file name>
+//   sprite <name> <page> <x> <y> <width> <height> <frames>
+//------------------------------------------------------------------------------
+struct AtlasRegion {
+    int  page   = -1;  ///< index into SpriteAtlas::pages, -1 = not packed
+    Rect rect{};       ///< pixel rectangle (all frames) inside that page
+    int  frames = 1;   ///< horizontal frame count
+};
+
+class SpriteAtlas {
+public:
+    static constexpr const char *IndexFile = "atlas.idx";
+
+    /// Read `dir`/atlas.idx. Fails if it is missing or stale, i.e. does not
+    /// cover every sprite in spritesList with matching frame counts.
+    bool load(const std::string &dir);
+
+    /// Same as load(), from an already opened table (e.g. an archive blob)
+    bool parse(std::istream &in);
+
+    /// Write `dir`/atlas.idx (page images are written by the packer)
+    bool save(const std::string &dir) const;
+    void write(std::ostream &out) const;
+
+    std::vector<std::string>               pages;    ///< page image file names
+    std::array<AtlasRegion, SpriteCount>   regions;  ///< indexed by SpriteId
+};
+
+#endif
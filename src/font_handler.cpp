@@ -0,0 +1,38 @@
+// font_handler.cpp
+#include "font_handler.hpp"
+
+void BitmapFont::drawGlyphs(const std::uint8_t *glyphs, int count, int x, int y, bool hidden)
+{
+    for (int i = 0; i < count; i++, x += FontCharWidth) {
+        if (glyphs[i] == NoGlyph) continue; // unknown glyph → skip
+
+        sheet_->drawFrame(hidden ? BlankGlyph : glyphs[i], x, y);
+    }
+}
+
+void BitmapFont::drawText(std::string_view text, int x, int y, bool hidden)
+{
+    for (char ch : text) {
+        std::uint8_t glyph = glyphTable[static_cast<unsigned char>(ch)];
+        if (glyph != NoGlyph) {
+            sheet_->drawFrame(hidden ? BlankGlyph : glyph, x, y);
+        }
+        x += FontCharWidth;
+    }
+}
+
+int BitmapFont::drawNumber(int value, int x, int y)
+{
+    // Fill digits right to left into a small stack buffer
+    std::uint8_t glyphs[12];
+    int          count = 0;
+    unsigned int v     = value < 0 ? 0u - unsigned(value) : unsigned(value);
+    do {
+        glyphs[sizeof(glyphs) - 1 - count++] = glyphTable['0' + v % 10];
+        v /= 10;
+    } while (v != 0);
+    if (value < 0) glyphs[sizeof(glyphs) - 1 - count++] = glyphTable['-'];
+
+    drawGlyphs(&glyphs[sizeof(glyphs) - count], count, x, y);
+    return count;
+}
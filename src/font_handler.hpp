@@ -0,0 +1,102 @@
+#ifndef _FONT_H_
+#define _FONT_H_
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+#include "settings.hpp"
+#include "sprite_handler.hpp"
+
+//------------------------------------------------------------------------------
+// Font metrics
+//------------------------------------------------------------------------------
+constexpr int FontCharWidth          = 8;  ///< pixel width of each glyph
+
+//------------------------------------------------------------------------------
+// Glyph lookup: ASCII → frame index in the font_symbols sheet, built at compile
+// time from spriteLetters. Characters without a glyph map to NoGlyph and are
+// skipped (the pen still advances).
+//------------------------------------------------------------------------------
+constexpr std::uint8_t NoGlyph = 0xFF;
+
+inline constexpr std::array<std::uint8_t, 256> glyphTable = [] {
+    std::array<std::uint8_t, 256> table{};
+    for (auto &g : table) g = NoGlyph;
+    for (std::size_t i = 0; i < spriteLetters.size(); i++)
+        table[static_cast<unsigned char>(spriteLetters[i])] = static_cast<std::uint8_t>(i);
+    return table;
+}();
+
+constexpr std::uint8_t BlankGlyph = glyphTable[' '];  ///< drawn while a blinking text is "off"
+
+//------------------------------------------------------------------------------
+// GlyphRun: a constant string already translated to glyph indices.
+//   static constexpr auto kScore = makeGlyphRun("score");
+//------------------------------------------------------------------------------
+template <std::size_t N>
+struct GlyphRun {
+    std::array<std::uint8_t, N> glyphs{};
+    static constexpr int size() { return int(N); }
+};
+
+template <std::size_t N>
+constexpr GlyphRun<N - 1> makeGlyphRun(const char (&text)[N])
+{
+    GlyphRun<N - 1> run{};
+    for (std::size_t i = 0; i + 1 < N; i++)
+        run.glyphs[i] = glyphTable[static_cast<unsigned char>(text[i])];
+    return run;
+}
+
+//------------------------------------------------------------------------------
+// TextBlink: blink state for one label, owned by whoever draws it
+//------------------------------------------------------------------------------
+struct TextBlink {
+    int frameTimer = 0;
+    int currFrame  = 0;
+
+    /// Advance one frame; returns true each time a full off→on cycle completes
+    inline bool tick() {
+        if (++frameTimer >= TARGET_FPS / FRAME_SPEED) {
+            frameTimer = 0;
+            if (++currFrame > 1) {
+                currFrame = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+    inline bool visible() const { return currFrame == 1; }
+    inline void reset()         { frameTimer = currFrame = 0; }
+};
+
+//------------------------------------------------------------------------------
+// BitmapFont: draws glyphs from the font_symbols sheet, FontCharWidth apart
+//------------------------------------------------------------------------------
+class BitmapFont {
+public:
+    explicit BitmapFont(const Sprite &sheet) : sheet_(&sheet) {}
+
+    /// Draw `count` glyph indices; `hidden` draws blanks in their place
+    void drawGlyphs(const std::uint8_t *glyphs, int count, int x, int y, bool hidden = false);
+
+    template <std::size_t N>
+    inline void draw(const GlyphRun<N> &run, int x, int y, bool hidden = false) {
+        drawGlyphs(run.glyphs.data(), int(N), x, y, hidden);
+    }
+
+    /// Runtime text: one table lookup per character, no allocation
+    void drawText(std::string_view text, int x, int y, bool hidden = false);
+
+    /// Decimal digits of `value`, no string conversion. Returns glyph count.
+    int drawNumber(int value, int x, int y);
+
+private:
+    const Sprite *sheet_;
+};
+
+#endif
@@ -0,0 +1,117 @@
+// frame_capture.cpp
+#include "frame_capture.hpp"
+#include "profiler.hpp"
+
+#include <chrono>
+#include <cstring>
+
+bool FrameCapture::open(const std::string &path, int width, int height, int fps, int slots,
+                        Overflow overflow)
+{
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) return false;
+
+    width_    = width;
+    height_   = height;
+    overflow_ = overflow;
+    slots_.assign(std::size_t(slots > 0 ? slots : 1),
+                  std::vector<std::uint32_t>(std::size_t(width) * height));
+    planes_.resize(std::size_t(width) * height * 3);
+    head_ = tail_ = submitted_ = dropped_ = 0;
+    stopping_ = false;
+
+    std::fprintf(file_, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, fps);
+    writer_ = std::thread(&FrameCapture::writerLoop, this);
+    return true;
+}
+
+void FrameCapture::close()
+{
+    if (file_ == nullptr) return;
+
+    stopping_.store(true, std::memory_order_release);
+    wake_.notify_one();
+    writer_.join();
+
+    std::fclose(file_);
+    file_ = nullptr;
+    slots_.clear();
+}
+
+//------------------------------------------------------------------------------
+// Producer (render thread)
+//------------------------------------------------------------------------------
+bool FrameCapture::submit(const std::uint32_t *pixels, bool bottomUp)
+{
+    if (file_ == nullptr) return false;
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+
+    const std::uint64_t head = head_.load(std::memory_order_relaxed);
+    while (head - tail_.load(std::memory_order_acquire) >= slots_.size()) {
+        if (overflow_ == Overflow::Drop) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);  // writer is behind
+            return false;
+        }
+        std::this_thread::yield();
+    }
+
+    std::uint32_t    *slot = slots_[head % slots_.size()].data();
+    const std::size_t row  = std::size_t(width_);
+    if (!bottomUp) {
+        std::memcpy(slot, pixels, row * height_ * sizeof(std::uint32_t));
+    }
+    else {
+        for (int y = 0; y < height_; y++)
+            std::memcpy(slot + y * row, pixels + (height_ - 1 - y) * row, row * sizeof(std::uint32_t));
+    }
+
+    head_.store(head + 1, std::memory_order_release);
+    wake_.notify_one();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Consumer (writer thread)
+//------------------------------------------------------------------------------
+void FrameCapture::writerLoop()
+{
+    PROFILE_THREAD("capture");
+    for (;;) {
+        const bool stopping = stopping_.load(std::memory_order_acquire);
+        std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+
+        for (; tail < head; tail++) {
+            writeFrame(slots_[tail % slots_.size()]);
+            tail_.store(tail + 1, std::memory_order_release);  // slot is free again
+        }
+        if (stopping) return;  // everything queued before close() is written
+
+        // submit() notifies without the mutex, so a wakeup can slip between
+        // the check above and the wait; the timeout bounds that delay
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wake_.wait_for(lock, std::chrono::milliseconds(5), [&] {
+            return stopping_.load(std::memory_order_acquire)
+                || head_.load(std::memory_order_acquire) != tail;
+        });
+    }
+}
+
+void FrameCapture::writeFrame(const std::vector<std::uint32_t> &frame)
+{
+    PROFILE_ZONE("FrameCapture::write");
+
+    // BT.601 studio range, full-resolution chroma (pixel art smears at 4:2:0)
+    const std::size_t n = frame.size();
+    unsigned char *y = planes_.data(), *u = y + n, *v = u + n;
+    for (std::size_t i = 0; i < n; i++) {
+        const int r = int(frame[i] & 0xFF), g = int((frame[i] >> 8) & 0xFF), b = int((frame[i] >> 16) & 0xFF);
+        y[i] = (unsigned char)((( 66 * r + 129 * g +  25 * b + 128) >> 8) +  16);
+        u[i] = (unsigned char)(((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+        v[i] = (unsigned char)(((112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+    }
+
+    std::fputs("FRAME\n", file_);
+    std::fwrite(planes_.data(), 1, planes_.size(), file_);
+}
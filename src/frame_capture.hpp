@@ -0,0 +1,78 @@
+#ifndef _FRAME_CAPTURE_H_
+#define _FRAME_CAPTURE_H_
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// FrameCapture: records presented frames to a Y4M (raw YUV 4:4:4) file
+// without slowing the render thread down.
+//
+// submit() copies the frame into a free slot of a fixed ring of pooled
+// buffers and returns; a background thread converts and writes the slots in
+// order. Single producer, single consumer, no locks on the submit path: when
+// every slot is still waiting to be written the frame is dropped (and
+// counted) instead of blocking. Offline renders that are not paced to the
+// wall clock (SoftwarePlatform) can ask to wait for a slot instead.
+//
+// Pixels are r | g << 8 | b << 16 | a << 24, like the rest of the backends.
+//------------------------------------------------------------------------------
+class FrameCapture {
+public:
+    /// What submit() does when every slot is still queued
+    enum class Overflow { Drop, Wait };
+
+    FrameCapture() = default;
+    ~FrameCapture() { close(); }
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /// Create `path`, write the stream header and start the writer thread
+    bool open(const std::string &path, int width, int height, int fps, int slots,
+              Overflow overflow = Overflow::Drop);
+    /// Write what is queued, stop the thread, close the file
+    void close();
+    inline bool isOpen() const { return file_ != nullptr; }
+
+    /// Queue one width x height frame (`bottomUp`: rows stored last to first).
+    /// With Overflow::Drop never blocks; false if the frame was dropped.
+    bool submit(const std::uint32_t *pixels, bool bottomUp = false);
+
+    inline std::uint64_t submitted() const { return submitted_.load(std::memory_order_relaxed); }
+    inline std::uint64_t dropped() const   { return dropped_.load(std::memory_order_relaxed); }
+    inline std::uint64_t written() const   { return tail_.load(std::memory_order_relaxed); }
+
+private:
+    void writerLoop();
+    /// Convert one slot to Y, U, V planes and append it to the file
+    void writeFrame(const std::vector<std::uint32_t> &frame);
+
+    std::FILE                              *file_   = nullptr;
+    int                                     width_  = 0;
+    int                                     height_ = 0;
+    Overflow                                overflow_ = Overflow::Drop;
+    std::vector<std::vector<std::uint32_t>> slots_;   ///< allocated once in open()
+    std::vector<unsigned char>              planes_;  ///< writer thread's Y4M frame
+
+    std::atomic<std::uint64_t>  head_{0};       ///< frames queued (written by submit)
+    std::atomic<std::uint64_t>  tail_{0};       ///< frames written (written by the writer)
+    std::atomic<std::uint64_t>  submitted_{0};
+    std::atomic<std::uint64_t>  dropped_{0};
+    std::atomic<bool>           stopping_{false};
+
+    // Only the writer waits on these; submit() just notifies
+    std::mutex                  wakeMutex_;
+    std::condition_variable     wake_;
+    std::thread                 writer_;
+};
+
+#endif
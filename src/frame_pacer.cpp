@@ -0,0 +1,100 @@
+// frame_pacer.cpp
+#include "frame_pacer.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// Simulation side
+//------------------------------------------------------------------------------
+InputSnapshot FramePacer::sampleInput()
+{
+    InputSnapshot input;
+    for (int k = 0; k < KeyCount; k++) {
+        Key key = Key(k);
+        input.set(key, backend_.isKeyDown(key) || pressedLatch_[k],
+                  releasedLatch_[k] || (polledSinceTick_ && backend_.isKeyReleased(key)));
+    }
+    pressedLatch_    = {};
+    releasedLatch_   = {};
+    polledSinceTick_ = false;
+    return input;
+}
+
+void FramePacer::beginFrame()
+{
+    if (muted_ & Mute::Draws) return;  // keep showing the last shown tick
+    prev_.swap(curr_);
+    curr_.clear();
+}
+
+//------------------------------------------------------------------------------
+// Render side
+//------------------------------------------------------------------------------
+namespace {
+    /// Same sheet (frames of one sprite share row, height and frame width)
+    inline bool sameKind(const DrawCommand &a, const DrawCommand &b) {
+        return a.texture.id == b.texture.id && a.src.y == b.src.y
+            && a.src.height == b.src.height && std::fabs(a.src.width) == std::fabs(b.src.width);
+    }
+}
+
+int FramePacer::findPrevious(const DrawCommand &cmd, std::size_t index) const
+{
+    // The n-th draw of this kind continues the n-th one of the previous tick
+    // (a frame is a few hundred draws at most, quadratic is fine here)
+    std::size_t rank = 0;
+    for (std::size_t i = 0; i < index; i++)
+        if (sameKind(curr_[i], cmd)) rank++;
+    for (std::size_t i = 0; i < prev_.size(); i++)
+        if (sameKind(prev_[i], cmd) && rank-- == 0) return int(i);
+    return -1;
+}
+
+void FramePacer::present(float alpha)
+{
+    PROFILE_ZONE("FramePacer::present");
+
+    // blend positions in recording order (findPrevious relies on it) ...
+    frame_.assign(curr_.begin(), curr_.end());
+    if (alpha < 1.0f) {
+        for (std::size_t i = 0; i < frame_.size(); i++) {
+            DrawCommand &cmd = frame_[i];
+            int p = findPrevious(cmd, i);
+            if (p < 0) continue;
+
+            const DrawCommand &from = prev_[p];
+            if (std::fabs(cmd.x - from.x) <= MaxLerpDistance
+                && std::fabs(cmd.y - from.y) <= MaxLerpDistance) {
+                cmd.x = from.x + (cmd.x - from.x) * alpha;
+                cmd.y = from.y + (cmd.y - from.y) * alpha;
+            }
+        }
+    }
+
+    // ... then back to front, grouped by texture. `order` makes the sort
+    // stable without std::stable_sort's temporary buffer.
+    std::sort(frame_.begin(), frame_.end(), [](const DrawCommand &a, const DrawCommand &b) {
+        if (a.layer != b.layer)           return a.layer < b.layer;
+        if (a.texture.id != b.texture.id) return a.texture.id < b.texture.id;
+        return a.order < b.order;
+    });
+
+    stats_ = {};
+    backend_.beginFrame();
+    for (std::size_t i = 0; i < frame_.size(); i++) {
+        const DrawCommand &cmd = frame_[i];
+        if (i == 0 || cmd.texture.id != frame_[i - 1].texture.id) stats_.batches++;
+        backend_.drawTexture(cmd.texture, cmd.src, cmd.x, cmd.y, cmd.layer);
+    }
+    stats_.draws = frame_.size();
+    backend_.endFrame();
+
+    // latch what this poll saw for the next tick
+    for (int k = 0; k < KeyCount; k++) {
+        pressedLatch_[k]  = pressedLatch_[k]  || backend_.isKeyDown(Key(k));
+        releasedLatch_[k] = releasedLatch_[k] || backend_.isKeyReleased(Key(k));
+    }
+    polledSinceTick_ = true;
+}
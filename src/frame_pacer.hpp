@@ -0,0 +1,164 @@
+#ifndef _FRAME_PACER_H_
+#define _FRAME_PACER_H_
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "platform_handler.hpp"
+#include "settings.hpp"
+
+//------------------------------------------------------------------------------
+// Fixed-timestep constants. Every gameplay counter (Timer, Sprite animation,
+// jump acceleration, enemy AI) counts simulation ticks, TARGET_FPS per second.
+//------------------------------------------------------------------------------
+constexpr double SimTickSeconds   = 1.0 / TARGET_FPS;
+constexpr double MaxFrameSeconds  = 0.25;   ///< longer stalls are dropped, not caught up
+constexpr float  MaxLerpDistance  = 16.0f;  ///< bigger jumps are teleports: no blending
+
+/// One recorded drawTexture call
+struct DrawCommand {
+    TextureHandle texture;
+    Rect          src;
+    float         x, y;
+    DrawLayer     layer;
+    std::uint16_t order;   ///< position in the tick (ties keep code order)
+};
+
+/// What a tick's output leaves out (FramePacer::setMuted), for ticks run
+/// again by a rollback or ahead of time by run-ahead
+namespace Mute {
+    enum : std::uint8_t {
+        None       = 0,
+        Draws      = 1,  ///< record no draws: the tick is not shown
+        Sounds     = 2,  ///< play no sounds: the tick was heard already, or will be
+        Persistent = 4,  ///< no music start/stop (nor texture residency changes,
+                         ///< see PreviewState): the tick is undone again
+        All        = Draws | Sounds | Persistent,
+    };
+}
+
+/// What the last present() submitted
+struct FrameStats {
+    std::size_t draws   = 0;
+    std::size_t batches = 0;  ///< runs of consecutive draws sharing a texture
+};
+
+//------------------------------------------------------------------------------
+// FramePacer: the Platform gameplay code sees, wrapping the real backend.
+//
+// Gameplay still draws as it simulates, so a simulation tick (the state's
+// beginFrame/draw/endFrame) only *records* its draw calls.
+// present() then renders at the display's own rate, blending each sprite
+// between the previous and the latest tick by `alpha` (the fraction of a
+// tick the clock is past the latest one), and submits the frame sorted by
+// DrawLayer and texture so each texture is bound once per layer.
+//
+// Input is latched between ticks: a key tapped or released during frames in
+// which no tick ran is still seen by the next tick, exactly once. Game passes
+// each tick's InputSnapshot back in (possibly from a replay) via setTickInput.
+//
+// Muted ticks leave out part of their output (see Mute): a tick recording no
+// draws keeps the last shown one on screen. Composing into a render target
+// always goes through, caches outlast the tick. Everything else (loading,
+// window) is forwarded untouched.
+//------------------------------------------------------------------------------
+class FramePacer : public Platform {
+public:
+    explicit FramePacer(Platform &backend) : backend_(backend) {}
+
+    /// Input for the next tick: live keys plus whatever was latched since
+    /// the previous tick (clears the latch)
+    InputSnapshot sampleInput();
+
+    /// Input the coming tick sees (live, or from a replay)
+    inline void setTickInput(InputSnapshot input) { input_ = input; }
+
+    /// Leave `mute` (Mute flags) out of the following ticks' output
+    inline void         setMuted(std::uint8_t mute) { muted_ = mute; }
+    inline std::uint8_t muted() const               { return muted_; }
+
+    /// Render the last two ticks blended by `alpha` (0..1) and poll input
+    void present(float alpha);
+
+    inline const std::vector<DrawCommand>& lastTick() const { return curr_; }
+    inline const FrameStats& lastFrameStats() const { return stats_; }
+
+    // ----------------------------------------------------------------
+    // Platform
+    void openWindow(int width, int height, const char *title) override { backend_.openWindow(width, height, title); }
+    void closeWindow() override { backend_.closeWindow(); }
+    bool shouldClose() override { return backend_.shouldClose(); }
+    double now() override { return backend_.now(); }
+
+    /// Tick-side frame: start/finish recording
+    void beginFrame() override;
+    void endFrame() override {}
+
+    bool isKeyDown(Key key) override     { return input_.down(key); }
+    bool isKeyReleased(Key key) override { return input_.released(key); }
+    bool isDebugKeyPressed(DebugKey key) override { return backend_.isDebugKeyPressed(key); }
+    bool isDebugKeyDown(DebugKey key) override    { return backend_.isDebugKeyDown(key); }
+
+    bool decodeImage(const std::string &path, PixelImage &out) override { return backend_.decodeImage(path, out); }
+    bool decodeWave(const std::string &path, PcmWave &out) override { return backend_.decodeWave(path, out); }
+
+    TextureHandle loadTexture(const std::string &path) override { return backend_.loadTexture(path); }
+    TextureHandle loadTextureFromPixels(int width, int height, const void *rgba) override {
+        return backend_.loadTextureFromPixels(width, height, rgba);
+    }
+    void unloadTexture(TextureHandle &texture) override { backend_.unloadTexture(texture); }
+    TextureHandle createRenderTarget(int width, int height) override {
+        return backend_.createRenderTarget(width, height);
+    }
+    void beginRenderTarget(const TextureHandle &target) override {
+        backend_.beginRenderTarget(target);
+        compositing_ = true;
+    }
+    void endRenderTarget() override {
+        backend_.endRenderTarget();
+        compositing_ = false;
+    }
+    void drawTexture(const TextureHandle &texture, const Rect &src, float x, float y,
+                     DrawLayer layer) override {
+        if (compositing_) backend_.drawTexture(texture, src, x, y, layer);
+        else if (!(muted_ & Mute::Draws)) curr_.push_back({ texture, src, x, y, layer, std::uint16_t(curr_.size()) });
+    }
+
+    SoundHandle loadSound(const std::string &path) override { return backend_.loadSound(path); }
+    SoundHandle loadSoundFromPcm(unsigned int frameCount, unsigned int sampleRate,
+                                 unsigned int sampleSize, unsigned int channels,
+                                 const void *samples) override {
+        return backend_.loadSoundFromPcm(frameCount, sampleRate, sampleSize, channels, samples);
+    }
+    void unloadSound(SoundHandle sound) override { backend_.unloadSound(sound); }
+    void playSound(SoundHandle sound) override   { if (!(muted_ & Mute::Sounds)) backend_.playSound(sound); }
+
+    MusicHandle loadMusic(const std::string &path) override { return backend_.loadMusic(path); }
+    MusicHandle loadMusicFromMemory(const char *fileType, const void *data, int size) override {
+        return backend_.loadMusicFromMemory(fileType, data, size);
+    }
+    void unloadMusic(MusicHandle music) override { backend_.unloadMusic(music); }
+    void playMusic(MusicHandle music) override   { if (!(muted_ & Mute::Persistent)) backend_.playMusic(music); }
+    void updateMusic(MusicHandle music) override { if (!(muted_ & Mute::Sounds)) backend_.updateMusic(music); }
+    void stopMusic(MusicHandle music) override   { if (!(muted_ & Mute::Persistent)) backend_.stopMusic(music); }
+
+private:
+    /// Index of the command in prev_ that `cmd` (the n-th of its kind) continues, or -1
+    int findPrevious(const DrawCommand &cmd, std::size_t index) const;
+
+    Platform                  &backend_;
+    std::vector<DrawCommand>   prev_, curr_;   ///< draws of the last two ticks
+    std::vector<DrawCommand>   frame_;         ///< blended + sorted, reused every present
+    FrameStats                 stats_;
+
+    InputSnapshot              input_;   ///< as seen by the current tick
+    std::array<bool, KeyCount> pressedLatch_{}, releasedLatch_{};
+    bool                       polledSinceTick_ = true;
+    bool                       compositing_ = false;  ///< inside begin/endRenderTarget
+    std::uint8_t               muted_       = Mute::None;
+};
+
+#endif
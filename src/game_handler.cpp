@@ -3,33 +3,118 @@
 #include "game_handler.hpp"
 #include "state_handler.hpp"
 #include "player_handler.hpp"
+#include "profiler.hpp"
+#include "rollback_session.hpp"
 
-#include <raylib.h>
 #include <vector>
 #include <string>
 #include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <algorithm>
+#include <random>
 
 using  std::vector;
 using  std::string;
 
+namespace {
+    inline bool inRange(std::int32_t value, std::int32_t min, std::int32_t max) { return value >= min && value <= max; }
+
+    /// A cursor of sheet `id` shows one of its frames
+    inline bool validAnim(const AnimSnapshot &anim, SpriteId id)
+    {
+        return inRange(anim.frame, 0, spriteFrameCounts[size_t(id)] - 1);
+    }
+
+    /// Everything restore() indexes with, or loops over, is in range: keyframes
+    /// come from files (see Replay::load), which only check their structure
+    bool snapshotInRange(const SimSnapshot &in)
+    {
+        constexpr std::int32_t MaxLives = 99;  // the HUD draws an icon per life
+
+        const PlaySnapshot   &play   = in.play;
+        const PlayerSnapshot &player = in.player;
+        bool valid = in.rng.valid()
+                  && inRange(in.state, int(GameState::Intro), int(GameState::Play))
+                  && inRange(in.level, 1, std::int32_t(EnemyCount))
+                  && inRange(play.enemyHealth, 0, DEFAULT_HEALTH)
+                  && inRange(play.enemyCurrentMove, int(EnemyAction::None), int(EnemyAction::Pause))
+                  && inRange(play.enemyRandomAttack, -1, 1) // none yet, kick or punch (attackList)
+                  && inRange(play.enemyMoveState, int(MoveState::FollowPlayer), int(MoveState::RetreatRunningRight))
+                  && inRange(play.endState, int(EndSequence::Start), int(EndSequence::GameOver))
+                  && inRange(play.enemyEndState, int(EnemyEndSequence::Start), int(EnemyEndSequence::GameOver))
+                  && validAnim(play.chainAnim, SpriteId::spinning_chain)
+                  && inRange(player.lives, 0, MaxLives)
+                  && inRange(player.health, 0, DEFAULT_HEALTH)
+                  && inRange(player.currAction, int(PlayerAction::None), int(PlayerAction::VeryDefeated))
+                  && inRange(player.prevAction, int(PlayerAction::None), int(PlayerAction::VeryDefeated))
+                  && validAnim(player.walkAnim, SpriteId::player_default)
+                  && validAnim(player.defeatedAnim, SpriteId::player_defeated)
+                  && validAnim(player.hitAnim, SpriteId::effect_hit);
+        for (size_t e = 0; valid && e < EnemyCount; e++)
+            for (size_t p = 0; valid && p < EnemyPoseCount; p++)
+                valid = validAnim(play.enemyAnims[e][p], enemySpriteTable[e][p]);
+        return valid;
+    }
+
+    /// Which DrawLayer a sprite sheet is drawn on (see platform_handler.hpp)
+    DrawLayer spriteLayer(SpriteId id)
+    {
+        if (enemyOfSprite(id) >= 0)
+            return id == enemySpriteTable[size_t(enemyOfSprite(id))][size_t(EnemyPose::Hit)]
+                 ? DrawLayer::Effects : DrawLayer::Enemy;
+
+        switch (id) {
+            case SpriteId::game_name:
+            case SpriteId::logo_konami:
+            case SpriteId::bg_dojo:        return DrawLayer::Background;
+            case SpriteId::spinning_chain: return DrawLayer::Props;
+            case SpriteId::effect_hit:     return DrawLayer::Effects;
+            case SpriteId::hud_health:     return DrawLayer::HudBack;
+            case SpriteId::font_symbols:
+            case SpriteId::life_icon:
+            case SpriteId::green_health:
+            case SpriteId::red_health:     return DrawLayer::Hud;
+            default:                       return DrawLayer::Player;  // player_*
+        }
+    }
+}
+
 // --------------------------------------------------------------------------------------
 // Constructor: set up window, audio, and initial game state
 // --------------------------------------------------------------------------------------
-Game::Game()
-    : state(GameState::Intro)
+Game::Game(Platform &backend)
+    : pacer_(backend)
+    , state(GameState::Intro)
     , level(1)
     , score(0)
+    , platform(pacer_)
+    , seed(std::random_device{}())
+    , rng(seed)
 {
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, GAME_TITLE);
-    InitAudioDevice();
-    SetTargetFPS(TARGET_FPS);
+    PROFILE_THREAD("main");
+    platform.openWindow(SCREEN_WIDTH, SCREEN_HEIGHT, GAME_TITLE);
 
     // ----------------------------------------------------------------------
-    // Load all sprite textures, music tracks, and sound effects into maps
+    // Load all sprite textures, music tracks, and sound effects. The packed
+    // archive (tools/asset_packer.cpp) is used when present, loose files
+    // otherwise.
     // ----------------------------------------------------------------------
-    initializeAllSprites(spritesList);
-    initializeMusicTracks(musicsList);
-    initializeSoundEffects(soundsList);
+    {
+        PROFILE_ZONE("Game::loadAssets");
+        auto start = std::chrono::steady_clock::now();
+
+        archive.open(ASSETS_PATH + ArchiveFile);
+        initializeAllSprites(workers);
+        initializeSoundEffects(workers);
+        initializeMusicTracks(workers);
+        initializeStageTiles();
+
+        loadWallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (PRINT_LOAD_REPORT) printLoadReport(workers.size());
+    }
 
     // ------------------------------------------------------------------
     // Attempt to restore last session (if any)
@@ -39,48 +124,31 @@ Game::Game()
     // ----------------------------------------------------------------------
     // Configure how many frames each animated sprite contains
     // ----------------------------------------------------------------------
-    // Player animations
-    sprites.at("player_default").setFrameCount(2);
-    sprites.at("player_defeated").setFrameCount(2);
-
-    // Wang animations
-    sprites.at("wang_default").setFrameCount(2);
-    sprites.at("wang_kick"   ).setFrameCount(2);
-    sprites.at("wang_punch"  ).setFrameCount(2);
-
-    // Tao animations
-    sprites.at("tao_default").setFrameCount(2);
-    sprites.at("tao_kick"   ).setFrameCount(2);
-    sprites.at("tao_punch"  ).setFrameCount(2);
-
-    // Chen animations
-    sprites.at("chen_default").setFrameCount(4);
-    sprites.at("chen_kick"   ).setFrameCount(2);
-    sprites.at("chen_punch"  ).setFrameCount(2);
-
-    // Lang animations
-    sprites.at("lang_default").setFrameCount(2);
-    sprites.at("lang_kick"   ).setFrameCount(2);
-    sprites.at("lang_punch"  ).setFrameCount(2);
-
-    // Mu animations
-    sprites.at("mu_default").setFrameCount(2);
-    sprites.at("mu_kick"   ).setFrameCount(2);
-    sprites.at("mu_punch"  ).setFrameCount(2);
-
-    // Special & font
-    sprites.at("spinning_chain").setFrameCount(8);
-    sprites.at("font_symbols"  ).setFrameCount(spriteLetters.size());
+    // (counts live next to each name in KUNGFU_SPRITES, see asset_ids.hpp)
+    static_assert(spriteFrameCounts[size_t(SpriteId::font_symbols)] == spriteLetters.size(),
+                  "font_symbols must have one frame per entry in spriteLetters");
+    for (size_t i = 0; i < SpriteCount; i++)
+    {
+        sprites[i].setFrameCount(spriteFrameCounts[i]);
+        sprites[i].layer = spriteLayer(SpriteId(i));
+    }
 
     // ----------------------------------------------------------------------
-    // Override frame‐advance speed for every enemy animation
+    // Override frame‐advance speed for every enemy animation (here, not in a
+    // state's init(): a restored state skips that)
     // ----------------------------------------------------------------------
-    for (const auto &spriteName : enemies)
+    for (const auto &set : enemySpriteTable)
     {
-        sprites.at(spriteName + "_default").setAnimationSpeed(EnemyWalkSpriteFPS);
-        sprites.at(spriteName + "_kick"   ).setAnimationSpeed(EnemyWalkSpriteFPS);
-        sprites.at(spriteName + "_punch"  ).setAnimationSpeed(EnemyWalkSpriteFPS);
+        sprite(set[size_t(EnemyPose::Default)]).setAnimationSpeed(EnemyWalkSpriteFPS);
+        sprite(set[size_t(EnemyPose::Kick)]   ).setAnimationSpeed(EnemyWalkSpriteFPS);
+        sprite(set[size_t(EnemyPose::Punch)]  ).setAnimationSpeed(EnemyWalkSpriteFPS);
     }
+    sprite(SpriteId::spinning_chain).setAnimationSpeed(SpinningChainSpriteFPS);
+
+    // ----------------------------------------------------------------------
+    // Only the (restored) level's enemy and the next one stay in memory
+    // ----------------------------------------------------------------------
+    residency.enterLevel(level);
 
     // ----------------------------------------------------------------------
     // Instantiate player and game states (intro, preview, play)
@@ -92,20 +160,247 @@ Game::Game()
 }
 
 // --------------------------------------------------------------------------------------
-// Main loop: dispatch to the current state until the window closes
+// Main loop: fixed-rate simulation ticks, rendering at whatever rate the display runs
 // --------------------------------------------------------------------------------------
 void Game::run()
 {
-    while (!IsKeyDown(KEY_ESCAPE) && !WindowShouldClose())
+    double previous = platform.now();
+    double lag      = 0;
+
+    while (!quitRequested() && !platform.shouldClose())
     {
-        if      (state == GameState::Intro)   introState->run();
-        else if (state == GameState::Preview) previewState->run();
-        else                                  playState->run();
+        double current = platform.now();
+        lag     += std::min(current - previous, MaxFrameSeconds);
+        previous = current;
+
+        while (lag >= SimTickSeconds)
+        {
+            tick();
+            lag -= SimTickSeconds;
+        }
+        present(float(lag / SimTickSeconds));
+
+        if (ProfilingEnabled && platform.isDebugKeyPressed(DebugKey::DumpProfile))
+            dumpProfile();
     }
 
+    if (ProfilingEnabled) dumpProfile();
     cleanUp();
-    saveState();
-    CloseWindow();
+    if (!versus) saveState();
+    if (replayMode_ == ReplayMode::Recording) replay.save(replayPath_);
+    platform.closeWindow();
+}
+
+void Game::dumpProfile()
+{
+    if (Profiler::writeChromeTrace(PROFILE_TRACE_FILE))
+        std::printf("profile: wrote %s\n", PROFILE_TRACE_FILE);
+}
+
+// --------------------------------------------------------------------------------------
+// Replays (see replay_handler.hpp)
+// --------------------------------------------------------------------------------------
+void Game::recordReplay(const string &path)
+{
+    replay.begin({ seed, std::int32_t(state), level, score });
+    replayPath_ = path;
+    replayMode_ = ReplayMode::Recording;
+}
+
+bool Game::playReplay(const string &path)
+{
+    if (!replay.load(path)) return false;
+
+    const ReplayStart &start = replay.start();
+    seed  = start.seed;
+    rng.seed(seed);
+    state = GameState(start.state);
+    level = start.level;
+    score = start.score;
+    residency.enterLevel(level);
+
+    // The whole starting simulation, when the file has it
+    if (const SimSnapshot *first = replay.seekKeyframe(0)) restore(*first);
+
+    replayMode_ = ReplayMode::Playing;
+    return true;
+}
+
+bool Game::seekReplay(std::uint32_t tick)
+{
+    if (replayMode_ == ReplayMode::Recording || tick > replay.tickCount()) return false;
+    PROFILE_ZONE("Game::seekReplay");
+
+    const SimSnapshot *keyframe = replay.seekKeyframe(tick);
+    if (keyframe == nullptr || !restore(*keyframe)) return false;
+
+    // The ticks from there on, simulated again unseen and unheard
+    pacer_.setMuted(Mute::Draws | Mute::Sounds);
+    InputSnapshot input;
+    while (replay.position() < tick && replay.next(input)) advance(input);
+    pacer_.setMuted(Mute::None);
+
+    replayMode_ = ReplayMode::Playing;
+    return true;
+}
+
+// --------------------------------------------------------------------------------------
+// Snapshots (see sim_snapshot.hpp)
+// --------------------------------------------------------------------------------------
+void Game::capture(SimSnapshot &out) const
+{
+    out.magic   = SnapshotMagic;
+    out.version = SnapshotVersion;
+    out.state   = std::int32_t(state);
+    out.level   = level;
+    out.score   = score;
+    out.seed    = seed;
+    out.rng     = rng;
+    introState->capture(out.intro);
+    previewState->capture(out.preview);
+    playState->capture(out.play);
+    player->capture(out.player);
+}
+
+bool Game::restore(const SimSnapshot &in)
+{
+    if (in.magic != SnapshotMagic || in.version != SnapshotVersion || !snapshotInRange(in)) return false;
+
+    // the restored level's enemy has to be drawable right away
+    if (in.level != level) residency.enterLevel(in.level);
+
+    state = GameState(in.state);
+    level = in.level;
+    score = in.score;
+    seed  = in.seed;
+    rng   = in.rng;
+    introState->restore(in.intro);
+    previewState->restore(in.preview);
+    playState->restore(in.play);
+    player->restore(in.player);
+    return true;
+}
+
+// --------------------------------------------------------------------------------------
+// Versus: straight to the first level's "get ready", whatever was saved
+// --------------------------------------------------------------------------------------
+void Game::startVersus(std::uint32_t sharedSeed)
+{
+    versus = true;
+    seed   = sharedSeed;
+    rng.seed(seed);
+    if (level != 1) residency.enterLevel(1);
+
+    state = GameState::Preview;
+    level = 1;
+    score = 0;
+    introState->cleanUp();
+    previewState->cleanUp();
+    playState->cleanUp();
+    player->lives = kPlayerDefaultLives;
+}
+
+void Game::tick()
+{
+    PROFILE_ZONE("Game::tick");
+    InputSnapshot input = pacer_.sampleInput();
+    if (netplay_ != nullptr)
+    {
+        localEscape_ = input.down(Key::Escape);  // the tick's input may be the other player's
+        netplay_->tick(input);                   // calls advance(), as often as rollbacks need
+        return;
+    }
+
+    if (replayMode_ == ReplayMode::Playing)
+    {
+        if (!replay.next(input))
+        {
+            replayMode_ = ReplayMode::Off; // replay over: live input from here on
+            input = pacer_.sampleInput();
+        }
+    }
+    else if (replayMode_ == ReplayMode::Recording)
+    {
+        if (replay.keyframeDue())
+        {
+            SimSnapshot keyframe;
+            capture(keyframe);
+            replay.addKeyframe(keyframe);
+        }
+        replay.record(input);
+    }
+
+    if (rewind_.capacity() > 0 && replayMode_ == ReplayMode::Off && state == GameState::Play)
+    {
+        if (platform.isDebugKeyDown(DebugKey::Rewind))
+        {
+            rewindTick();
+            return;
+        }
+        if (level != rewindLevel_) rewind_.clear();
+        rewindLevel_ = level;
+        capture(rewindFrame_);
+        rewind_.push(rewindFrame_, input);
+    }
+
+    if (runAhead_ == 0)
+    {
+        advance(input);
+        return;
+    }
+
+    // The real tick is heard but not shown ...
+    pacer_.setMuted(Mute::Draws);
+    advance(input);
+    capture(runAheadFrom_);
+
+    // ... the one `runAhead_` ticks later is shown but not heard, then undone.
+    // Keys stay held; a release happened once, in the real tick.
+    InputSnapshot held;
+    held.bits = input.bits & std::uint16_t((1u << KeyCount) - 1);
+    for (int i = 1; i <= runAhead_; i++)
+    {
+        pacer_.setMuted(i == runAhead_ ? Mute::Sounds | Mute::Persistent : Mute::All);
+        advance(held);
+    }
+    pacer_.setMuted(Mute::None);
+    restore(runAheadFrom_);
+}
+
+void Game::setRunAhead(int frames)
+{
+    runAhead_ = std::clamp(frames, 0, MaxRunAhead);
+}
+
+void Game::setRewind(int seconds)
+{
+    rewind_.reset(std::max(seconds, 0) * TARGET_FPS);
+}
+
+void Game::rewindTick()
+{
+    PROFILE_ZONE("Game::rewindTick");
+
+    // Take the last tick back out; past the oldest one, stay there
+    if (!rewind_.pop(rewindFrame_, rewindInput_)) capture(rewindFrame_);
+    restore(rewindFrame_);
+
+    // Drawn by running it again, without sounds or music, then undone
+    pacer_.setMuted(Mute::Sounds | Mute::Persistent);
+    advance(rewindInput_);
+    pacer_.setMuted(Mute::None);
+    restore(rewindFrame_);
+}
+
+void Game::advance(InputSnapshot input, InputSnapshot enemy)
+{
+    pacer_.setTickInput(input);
+    enemyInput = enemy;
+    residency.update();
+
+    if      (state == GameState::Intro)   introState->run();
+    else if (state == GameState::Preview) previewState->run();
+    else                                  playState->run();
 }
 
 // ----------------------------------------------------------------------
@@ -146,70 +441,326 @@ void Game::loadState()
 
 // --------------------------------------------------------------------------------------
 // Helpers: batch‐load textures, music, and sound effects from lists of names
+// (stored at the index of their SpriteId / MusicId / SoundId, see asset_ids.hpp).
+// Files are decoded on the worker pool; only the upload runs here, in list
+// order, overlapping with decoding of the assets still queued.
 // --------------------------------------------------------------------------------------
-void Game::initializeAllSprites(const vector<string> &spritesList)
-{
-    for (const auto &name : spritesList)
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    inline double msSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    template <class T>
+    struct Decoded {
+        T      value;
+        bool   ok       = false;
+        double decodeMs = 0;
+    };
+
+    bool readFile(const string &path, vector<unsigned char> &out)
     {
-        sprites.emplace(name, Sprite(ASSETS_PATH + "images/" + name + ".png"));
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+        if (!ifs) return false;
+        out.resize(size_t(ifs.tellg()));
+        ifs.seekg(0);
+        return bool(ifs.read(reinterpret_cast<char*>(out.data()), std::streamsize(out.size())));
     }
 }
 
-void Game::initializeMusicTracks(const vector<string> &musicsList)
+vector<TextureHandle> Game::loadTextures(WorkerPool &pool, const vector<string> &paths)
 {
-    for (const auto &name : musicsList)
+    vector<std::future<Decoded<PixelImage>>> jobs;
+    for (const string &path : paths)
+    {
+        jobs.push_back(pool.submit([this, &path] {
+            Decoded<PixelImage> d;
+            auto start = Clock::now();
+            d.ok       = platform.decodeImage(path, d.value);
+            d.decodeMs = msSince(start);
+            return d;
+        }));
+    }
+
+    vector<TextureHandle> textures;
+    for (size_t i = 0; i < paths.size(); i++)
     {
-        musics.emplace(name,
-            LoadMusicStream((ASSETS_PATH + "musics/" + name + ".mp3").c_str()));
+        Decoded<PixelImage> d = jobs[i].get();
+        auto start = Clock::now();
+        const PixelImage &img = d.value;
+        textures.push_back(d.ok ? platform.loadTextureFromPixels(img.width, img.height, img.rgba.data())
+                                : TextureHandle{});
+        loadTimings.push_back({ paths[i], d.decodeMs, msSince(start) });
     }
+    return textures;
 }
 
-void Game::initializeSoundEffects(const vector<string> &soundsList)
+void Game::initializeAllSprites(WorkerPool &pool)
 {
-    for (const auto &name : soundsList)
+    // ----------------------------------------------------------------------
+    // Pick the source: archive atlas → archive images → atlas files → loose
+    // PNGs. With an atlas every sprite draws from a few shared pages.
+    // ----------------------------------------------------------------------
+    SpriteAtlas    atlas;
+    bool           useAtlas = false, archived = false;
+    string         prefix;
+    vector<string> files;  // one per texture: atlas pages, or one image per sprite
+
+    auto allInArchive = [this](const string &dir, const vector<string> &names) {
+        for (const auto &name : names)
+            if (!archive.find(dir + name, ArchiveEntryType::Image)) return false;
+        return true;
+    };
+
+    if (archive.isOpen())
+    {
+        const ArchiveEntry *idx = archive.find(string("atlas/") + SpriteAtlas::IndexFile, ArchiveEntryType::Blob);
+        std::istringstream in(idx ? string(reinterpret_cast<const char*>(archive.data(*idx)), idx->size) : string());
+        vector<string> images(spritesList.begin(), spritesList.end());
+
+        if (idx && atlas.parse(in) && allInArchive("atlas/", atlas.pages))
+        {
+            useAtlas = archived = true;
+            prefix   = "atlas/";
+        }
+        else if (allInArchive("images/", images))
+        {
+            archived = true;
+            prefix   = "images/";
+        }
+    }
+    if (!archived)
+    {
+        useAtlas = atlas.load(ASSETS_PATH + "atlas/");
+        prefix   = ASSETS_PATH + (useAtlas ? "atlas/" : "images/");
+    }
+
+    if (useAtlas) files = atlas.pages;
+    else for (const char *name : spritesList) files.push_back(string(name) + (archived ? "" : ".png"));
+
+    auto textureOf = [&](size_t sprite) { return useAtlas ? size_t(atlas.regions[sprite].page) : sprite; };
+
+    // ----------------------------------------------------------------------
+    // Textures used by one enemy only go to EnemyResidency (loaded per
+    // level); the rest are loaded now.
+    // ----------------------------------------------------------------------
+    constexpr int Unused = -2, Shared = -1;
+    vector<int> owner(files.size(), Unused);
+    for (size_t i = 0; i < SpriteCount; i++)
+    {
+        int &o = owner[textureOf(i)];
+        int  e = enemyOfSprite(SpriteId(i));
+        o = (o == Unused || o == e) ? e : Shared;
+    }
+
+    vector<TextureHandle> textures(files.size());
+    vector<string>        paths;
+    vector<size_t>        pathTexture;
+    for (size_t t = 0; t < files.size(); t++)
     {
-        sounds.emplace(name,
-            LoadSound((ASSETS_PATH + "sounds/" + name + ".wav").c_str()));
+        if (owner[t] != Shared) continue;
+        if (archived) textures[t] = archiveTexture(prefix + files[t]);
+        else { paths.push_back(prefix + files[t]); pathTexture.push_back(t); }
     }
+    vector<TextureHandle> loaded = loadTextures(pool, paths);
+    for (size_t k = 0; k < loaded.size(); k++) textures[pathTexture[k]] = loaded[k];
+
+    for (size_t t = 0; t < files.size(); t++)
+    {
+        if (owner[t] < 0) continue;
+        EnemyResidency::Texture tex;
+        tex.source     = prefix + files[t];
+        tex.archived   = archived;
+        tex.wholeImage = !useAtlas;
+        for (size_t i = 0; i < SpriteCount; i++)
+        {
+            if (textureOf(i) == t) tex.users.push_back({ SpriteId(i), atlas.regions[i].rect });
+        }
+        residency.addTexture(size_t(owner[t]), std::move(tex));
+    }
+
+    // ----------------------------------------------------------------------
+    // Sprites (enemy ones stay empty until EnemyResidency attaches a texture)
+    // ----------------------------------------------------------------------
+    sprites.reserve(SpriteCount);
+    for (size_t i = 0; i < SpriteCount; i++)
+    {
+        if (useAtlas)                 sprites.emplace_back(platform, textures[textureOf(i)], atlas.regions[i].rect);
+        else if (owner[i] == Shared)  sprites.emplace_back(platform, textures[i]);
+        else                          sprites.emplace_back(platform, TextureHandle{}, Rect{});
+    }
+    if (useAtlas) atlasPages = textures;  // enemy pages stay 0 here, EnemyResidency owns them
 }
 
-// --------------------------------------------------------------------------------------
-// Tear down all resources: textures, render-to-texture targets, sound & music
-// --------------------------------------------------------------------------------------
-void Game::cleanUp()
+void Game::initializeMusicTracks(WorkerPool &pool)
 {
-    // Unload all sprite textures
-    for (const auto &spriteName : spritesList)
+    // Music is streamed, so there is nothing to decode up front: workers only
+    // read the files and the stream decodes from memory (kept in musicFiles).
+    std::array<std::future<Decoded<vector<unsigned char>>>, MusicCount> jobs;
+    for (size_t i = 0; i < MusicCount; i++)
     {
-        sprites.at(spriteName).unload();
+        if (archive.find(string("musics/") + musicsList[i], ArchiveEntryType::Blob)) continue;
+
+        jobs[i] = pool.submit([i] {
+            Decoded<vector<unsigned char>> d;
+            auto start = Clock::now();
+            d.ok       = readFile(ASSETS_PATH + "musics/" + musicsList[i] + ".mp3", d.value);
+            d.decodeMs = msSince(start);
+            return d;
+        });
     }
 
-    // Unload render textures used by each state
-    previewState->unloadTexture();
-    playState->unloadTexture();
-    introState->unloadTexture();
+    for (size_t i = 0; i < MusicCount; i++)
+    {
+        auto start = Clock::now();
+        double decodeMs = 0;
 
-    // Unload all sound effects
-    for (const auto &spriteName : soundsList)
+        // Music stays encoded in the archive and streams from the mapping
+        if (const ArchiveEntry *e = archive.find(string("musics/") + musicsList[i], ArchiveEntryType::Blob))
+        {
+            musics[i] = platform.loadMusicFromMemory(".mp3", archive.data(*e), int(e->size));
+        }
+        else
+        {
+            auto d = jobs[i].get();
+            decodeMs = d.decodeMs;
+            start = Clock::now();
+            musicFiles[i] = std::move(d.value);
+            musics[i] = d.ok ? platform.loadMusicFromMemory(".mp3", musicFiles[i].data(), int(musicFiles[i].size()))
+                             : MusicHandle{};
+        }
+        loadTimings.push_back({ string("musics/") + musicsList[i], decodeMs, msSince(start) });
+    }
+}
+
+void Game::initializeSoundEffects(WorkerPool &pool)
+{
+    std::array<std::future<Decoded<PcmWave>>, SoundCount> jobs;
+    for (size_t i = 0; i < SoundCount; i++)
     {
-        UnloadSound(sounds.at(spriteName));
+        if (archive.find(string("sounds/") + soundsList[i], ArchiveEntryType::Wave)) continue;
+
+        jobs[i] = pool.submit([this, i] {
+            Decoded<PcmWave> d;
+            auto start = Clock::now();
+            d.ok       = platform.decodeWave(ASSETS_PATH + "sounds/" + soundsList[i] + ".wav", d.value);
+            d.decodeMs = msSince(start);
+            return d;
+        });
     }
 
-    // Unload all streaming music tracks
-    for (const auto &spriteName : musicsList)
+    for (size_t i = 0; i < SoundCount; i++)
+    {
+        auto start = Clock::now();
+        double decodeMs = 0;
+
+        if (const ArchiveEntry *e = archive.find(string("sounds/") + soundsList[i], ArchiveEntryType::Wave))
+        {
+            sounds[i] = platform.loadSoundFromPcm(e->params[0], e->params[1], e->params[2],
+                                                  e->params[3], archive.data(*e));
+        }
+        else
+        {
+            auto d = jobs[i].get();
+            decodeMs = d.decodeMs;
+            start = Clock::now();
+            const PcmWave &w = d.value;
+            sounds[i] = d.ok ? platform.loadSoundFromPcm(w.frameCount, w.sampleRate, w.sampleSize,
+                                                         w.channels, w.samples.data())
+                             : SoundHandle{};
+        }
+        loadTimings.push_back({ string("sounds/") + soundsList[i], decodeMs, msSince(start) });
+    }
+}
+
+// --------------------------------------------------------------------------------------
+// Stage background tiles (tools/tile_converter.cpp), from the archive or
+// assets/tiles/. Missing is fine: PlayState then draws the bg_dojo sprite.
+// --------------------------------------------------------------------------------------
+void Game::initializeStageTiles()
+{
+    const string name = "tiles/bg_dojo";
+    auto start = Clock::now();
+
+    const ArchiveEntry *e = archive.find(name, ArchiveEntryType::Blob);
+    const bool loaded = e ? stageTiles.parse(archive.data(*e), e->size)
+                          : stageTiles.load(ASSETS_PATH + name + TileMapExtension);
+    if (loaded && stageTiles.upload(platform))
+        loadTimings.push_back({ name, 0, msSince(start) });
+}
+
+// --------------------------------------------------------------------------------------
+// Archive helpers
+// --------------------------------------------------------------------------------------
+TextureHandle Game::archiveTexture(const string &name)
+{
+    const ArchiveEntry *e = archive.find(name, ArchiveEntryType::Image);
+    if (!e || size_t(e->params[0]) * e->params[1] * 4 != e->size) return {};
+
+    auto start = Clock::now();
+    TextureHandle tex = platform.loadTextureFromPixels(int(e->params[0]), int(e->params[1]), archive.data(*e));
+    loadTimings.push_back({ name, 0, msSince(start) });
+    return tex;
+}
+
+// --------------------------------------------------------------------------------------
+// Startup timing report: slowest decodes first, then totals. "decode" is
+// worker time (file read + decompress), "upload" is main-thread time.
+// --------------------------------------------------------------------------------------
+void Game::printLoadReport(unsigned int workers) const
+{
+    vector<const AssetLoadTiming*> rows;
+    double decodeTotal = 0, uploadTotal = 0;
+    for (const auto &t : loadTimings)
     {
-        UnloadMusicStream(musics.at(spriteName));
+        rows.push_back(&t);
+        decodeTotal += t.decodeMs;
+        uploadTotal += t.uploadMs;
     }
+    std::sort(rows.begin(), rows.end(), [](const AssetLoadTiming *a, const AssetLoadTiming *b) {
+        return a->decodeMs + a->uploadMs > b->decodeMs + b->uploadMs;
+    });
 
-    CloseAudioDevice();
+    std::printf("asset load report (%u workers%s)\n", workers, archive.isOpen() ? ", archive" : "");
+    std::printf("  %9s %9s  %s\n", "decode ms", "upload ms", "asset");
+    for (const auto *t : rows)
+    {
+        std::printf("  %9.2f %9.2f  %s\n", t->decodeMs, t->uploadMs, t->name.c_str());
+    }
+    std::printf("  %9.2f %9.2f  total (%zu assets), %.2f ms wall\n",
+                decodeTotal, uploadTotal, loadTimings.size(), loadWallMs);
 }
 
 // --------------------------------------------------------------------------------------
-// Entry point: create Game instance and hand control to its run() method
+// Tear down all resources: textures, sound & music
 // --------------------------------------------------------------------------------------
-int main()
+void Game::cleanUp()
 {
-    Game game;
-    game.run();
-    return EXIT_SUCCESS;
+    introState->releaseRenderTargets();
+    playState->releaseRenderTargets();
+
+    // Unload all sprite textures
+    for (auto &spr : sprites)
+    {
+        spr.unload();
+    }
+    for (auto &page : atlasPages)
+    {
+        platform.unloadTexture(page);
+    }
+    residency.unloadAll();
+    stageTiles.release(platform);
+
+    // Unload all sound effects
+    for (SoundHandle snd : sounds)
+    {
+        platform.unloadSound(snd);
+    }
+
+    // Unload all streaming music tracks
+    for (MusicHandle mus : musics)
+    {
+        platform.unloadMusic(mus);
+    }
 }
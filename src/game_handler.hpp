@@ -2,39 +2,67 @@
 #pragma once
 
 #include <unordered_map>
-#include <raylib.h>
-#include <random>
+#include <array>
 #include <vector>
 #include <string>
 
+#include "asset_ids.hpp"
+#include "atlas_handler.hpp"
+#include "asset_archive.hpp"
+#include "worker_pool.hpp"
+#include "residency_handler.hpp"
+#include "frame_pacer.hpp"
+#include "replay_handler.hpp"
+#include "rewind_buffer.hpp"
+#include "sim_snapshot.hpp"
 #include "sprite_handler.hpp"
+#include "tile_map.hpp"
 #include "state_handler.hpp"
 #include "player_handler.hpp"
 #include "settings.hpp"
+#include "platform_handler.hpp"
 
 using std::string;
 using std::vector;
 using std::unordered_map;
 
-//------------------------------------------------------------------------------
-// Game‐state identifiers
-//------------------------------------------------------------------------------
-enum class GameState : int {
-    Intro = 0,   ///< Title/intro screen
-    Preview = 1, ///< “Get ready” screen before each level
-    Play = 2     ///< Actual gameplay
+/// Startup cost of one asset (see Game::printLoadReport)
+struct AssetLoadTiming {
+    string name;
+    double decodeMs;  ///< on a worker (0 when pre-decoded in the archive)
+    double uploadMs;  ///< on the main thread
 };
 
 class Player;
 class PlayState; class IntroState; class PreviewState; 
+class RollbackSession;
 
 class Game {
 private:
-    std::mt19937               _rng;
+    FramePacer                 pacer_;      ///< records ticks, presents them interpolated
+
+    enum class ReplayMode { Off, Recording, Playing };
+    ReplayMode                 replayMode_ = ReplayMode::Off;
+    std::string                replayPath_;  ///< where a recording is saved on exit
+    RollbackSession           *netplay_ = nullptr;  ///< versus over the network: it runs the ticks
+    bool                       localEscape_ = false;  ///< this player's Escape, under netplay
+    int                        runAhead_    = 0;      ///< ticks simulated past the real one (0: off)
+    SimSnapshot                runAheadFrom_{};       ///< the real tick, put back after running ahead
+    RewindBuffer               rewind_;               ///< practice history (capacity 0: off)
+    SimSnapshot                rewindFrame_{};        ///< the tick on screen while rewinding
+    InputSnapshot              rewindInput_;          ///< ... and the input it ran with
+    int                        rewindLevel_ = 0;      ///< level of the ticks in rewind_
+
+    bool quitRequested() { return netplay_ != nullptr ? localEscape_ : platform.isKeyDown(Key::Escape); }
     void cleanUp();
-    void initializeAllSprites(const vector<string>& list);
-    void initializeMusicTracks(const vector<string>& list);
-    void initializeSoundEffects(const vector<string>& list);
+    void initializeAllSprites(WorkerPool &pool);
+    void initializeMusicTracks(WorkerPool &pool);
+    void initializeSoundEffects(WorkerPool &pool);
+    void initializeStageTiles();
+    vector<TextureHandle> loadTextures(WorkerPool &pool, const vector<string> &paths);
+    void printLoadReport(unsigned int workers) const;
+    void dumpProfile();   ///< write PROFILE_TRACE_FILE (see profiler.hpp)
+    void rewindTick();    ///< one tick backward (see setRewind)
 
     
 
@@ -54,13 +82,126 @@ public:
     PlayState*                  playState    = nullptr;
     Player*                     player       = nullptr;
 
-    unordered_map<string, Sprite>   sprites;
-    unordered_map<string, Music>    musics;
-    unordered_map<string, Sound>    sounds;
+    Platform&                   platform;    ///< what gameplay talks to (the FramePacer over the backend)
+    AssetArchive                archive;     ///< kungfu.pak mapping (music streams from it)
+    std::array<vector<unsigned char>, MusicCount> musicFiles; ///< encoded music read from disk (streams from it)
+    vector<AssetLoadTiming>     loadTimings; ///< one per texture/sound/music, in load order
+    double                      loadWallMs = 0;
 
-    Game();
+    vector<Sprite>                       sprites;  ///< indexed by SpriteId
+    vector<TextureHandle>                atlasPages; ///< shared by sprites when an atlas is used
+    std::array<MusicHandle, MusicCount>  musics;   ///< indexed by MusicId
+    std::array<SoundHandle, SoundCount>  sounds;   ///< indexed by SoundId
+    TileMap                              stageTiles; ///< bg_dojo as tiles, if converted (not ready: use the sprite)
+
+    WorkerPool                  workers{LOADER_THREADS};  ///< asset decoding (startup + prefetch)
+    EnemyResidency              residency{*this};         ///< per-level enemy textures
+
+    /// Upload an RGBA8 image from the archive ({} if missing/invalid)
+    TextureHandle archiveTexture(const std::string &name);
+
+    inline Sprite&     sprite(SpriteId id)      { return sprites[size_t(id)]; }
+    inline SoundHandle sound(SoundId id) const  { return sounds[size_t(id)]; }
+    inline MusicHandle music(MusicId id) const  { return musics[size_t(id)]; }
+
+    //------------------------------------------------------------------------
+    // Determinism: all gameplay randomness comes from `rng`, all input from
+    // the per-tick InputSnapshot, so (seed, inputs) replay a session exactly
+    //------------------------------------------------------------------------
+    std::uint32_t               seed;
+    SimRng                      rng;
+    Replay                      replay;
+
+    /// Uniform integer in [min, max]; same sequence on every platform
+    /// (std::uniform_int_distribution is implementation-defined)
+    inline int randBetween(int min, int max) {
+        return min + int(rng() % std::uint32_t(max - min + 1));
+    }
+
+    /// Record every tick from now on; written to `path` when run() returns.
+    /// Call before the first tick.
+    void recordReplay(const std::string &path);
+
+    /// Restore the replay's seed and starting state and feed its inputs to
+    /// the following ticks. Call before the first tick. False if unreadable.
+    bool playReplay(const std::string &path);
+
+    /// Continue the loaded replay from `tick`: restore the keyframe at or
+    /// before it, then simulate the ticks in between with output muted.
+    /// False (nothing changed) while recording or if the file has no
+    /// usable keyframes (see replay_handler.hpp).
+    bool seekReplay(std::uint32_t tick);
+
+    /// Copy the whole simulation into `out` (see sim_snapshot.hpp)
+    void capture(SimSnapshot &out) const;
+
+    /// Put a captured simulation back; the next tick continues from it.
+    /// False (and nothing changed) if `in` is not a snapshot of this version
+    /// or holds an out-of-range level, state or other index.
+    bool restore(const SimSnapshot &in);
+
+    //------------------------------------------------------------------------
+    // Versus: a second player drives the enemy instead of its AI, from the
+    // second InputSnapshot of each tick (see rollback_session.hpp)
+    //------------------------------------------------------------------------
+    bool                        versus = false;
+    InputSnapshot               enemyInput;   ///< the second player's keys this tick
+
+    /// Fresh versus match from `sharedSeed`: both peers call this with the
+    /// same seed, so both simulations start equal
+    void startVersus(std::uint32_t sharedSeed);
+
+    /// Let `session` run every tick from now on (nullptr: local play)
+    void setNetplay(RollbackSession *session) { netplay_ = session; }
+
+    /// Leave `mute` (Mute flags, frame_pacer.hpp) out of the following ticks
+    void muteOutput(std::uint8_t mute)       { pacer_.setMuted(mute); }
+    bool outputMuted(std::uint8_t what) const { return (pacer_.muted() & what) != 0; }
+
+    //------------------------------------------------------------------------
+    // Run-ahead: each tick also simulates `frames` ticks further with the same
+    // keys held, shows that future and puts the simulation back. Input shows
+    // up `frames` ticks earlier; sounds (and hit sparks) stay with the real tick.
+    //------------------------------------------------------------------------
+    static constexpr int MaxRunAhead = 8;
+
+    /// 0 turns it off; ignored under netplay (rollback already hides latency)
+    void setRunAhead(int frames);
+    int  runAhead() const { return runAhead_; }
+
+    //------------------------------------------------------------------------
+    // Rewind, for practice: every PlayState tick is kept (rewind_buffer.hpp),
+    // and while DebugKey::Rewind is held the match steps back one tick per
+    // tick instead of advancing. Letting go plays on from there. History
+    // starts over on a new level, whose enemy textures may not be resident.
+    //------------------------------------------------------------------------
+
+    /// Keep the last `seconds` of play (0: off); ignored while a replay is
+    /// recorded or played and under netplay
+    void setRewind(int seconds = REWIND_SECONDS);
+    const RewindBuffer& rewindHistory() const { return rewind_; }
+
+    explicit Game(Platform &backend);
+
+    /// Fixed-timestep loop until the platform asks to quit, then tear down:
+    /// as many ticks as the clock owes, then one interpolated present
     void run();
 
+    /// Advance the simulation by exactly one tick (input → logic/draw record)
+    void tick();
+
+    /// The simulation part of a tick, with the given inputs (hero, enemy)
+    void advance(InputSnapshot input, InputSnapshot enemy = {});
+
+    /// Render the last tick, blended `alpha` of the way from the one before
+    void present(float alpha = 1.0f) { pacer_.present(alpha); }
+
+    /// Draws and texture batches of the last present()
+    const FrameStats& frameStats() const { return pacer_.lastFrameStats(); }
+
+    /// One tick, presented as-is (headless drivers, tools)
+    void step() { tick(); present(); }
+
     //------------------------------------------------------------------------
     // Auto-save key: where we keep our binary state on disk
     //------------------------------------------------------------------------
@@ -72,13 +213,3 @@ public:
     void saveState();
     void loadState();
 };
-
-// ----------------------------------------------------------------
-// Asset lists
-inline const vector<string> musicsList = {
-    "main_music"
-};
-
-inline const vector<string> soundsList = {
-    "attack", "collision", "game_over", "defeated", "win", "counting","health_low","twitch_feet", "collision2"
-}; 
\ No newline at end of file
@@ -0,0 +1,85 @@
+// hud_handler.cpp
+#include "hud_handler.hpp"
+
+//------------------------------------------------------------------------------
+// Widget setup
+//------------------------------------------------------------------------------
+void Hud::addGauge(const int &value, const Sprite &pip, const Sprite &lowPip, int lowThreshold,
+                   int x, int y, int step)
+{
+    HudWidget w{ HudWidget::Kind::Gauge, &value };
+    w.x = x; w.y = y; w.step = step;
+    w.sprite       = &pip;
+    w.lowSprite    = &lowPip;
+    w.lowThreshold = lowThreshold;
+    widgets_.push_back(w);
+    composed_ = false;
+}
+
+void Hud::addCounter(const int &value, BitmapFont &font, int x, int y)
+{
+    HudWidget w{ HudWidget::Kind::Counter, &value };
+    w.x = x; w.y = y;
+    w.font = &font;
+    widgets_.push_back(w);
+    composed_ = false;
+}
+
+void Hud::addIconRow(const int &value, const Sprite &icon, int x, int y, int step)
+{
+    HudWidget w{ HudWidget::Kind::IconRow, &value };
+    w.x = x; w.y = y; w.step = step;
+    w.sprite = &icon;
+    widgets_.push_back(w);
+    composed_ = false;
+}
+
+//------------------------------------------------------------------------------
+// Drawing
+//------------------------------------------------------------------------------
+void Hud::drawWidgets()
+{
+    for (HudWidget &w : widgets_) {
+        w.shown = *w.value;
+        switch (w.kind) {
+            case HudWidget::Kind::Counter:
+                w.font->drawNumber(w.shown, w.x, w.y);
+                break;
+            case HudWidget::Kind::Gauge:
+            case HudWidget::Kind::IconRow: {
+                const Sprite &spr = (w.kind == HudWidget::Kind::Gauge && w.shown <= w.lowThreshold)
+                                  ? *w.lowSprite : *w.sprite;
+                for (int i = 0; i < w.shown; i++)
+                    spr.drawFrame(0, w.x + i * w.step, w.y);
+                break;
+            }
+        }
+    }
+}
+
+void Hud::draw(Platform &platform)
+{
+    if (surface_.id == 0) {
+        surface_ = platform.createRenderTarget(GAME_WIDTH, GAME_HEIGHT);
+        composed_ = false;
+        if (surface_.id == 0) { drawWidgets(); return; } // no render targets
+    }
+
+    for (const HudWidget &w : widgets_)
+        composed_ = composed_ && w.shown == *w.value;
+
+    if (!composed_) {
+        platform.beginRenderTarget(surface_);
+        drawWidgets();
+        platform.endRenderTarget();
+        composed_ = true;
+    }
+    platform.drawTexture(surface_, { 0, 0, float(GAME_WIDTH), float(GAME_HEIGHT) },
+                          0, 0, DrawLayer::Hud);
+}
+
+void Hud::release(Platform &platform)
+{
+    if (surface_.id != 0) platform.unloadTexture(surface_);
+    composed_ = false;
+}
@@ -0,0 +1,61 @@
+#ifndef _HUD_H_
+#define _HUD_H_
+
+#pragma once
+
+#include <climits>
+#include <vector>
+
+#include "platform_handler.hpp"
+#include "sprite_handler.hpp"
+#include "font_handler.hpp"
+
+//------------------------------------------------------------------------------
+// HudWidget: one retained HUD element bound to an int it displays
+//   Gauge   – `value` pips, `step` px apart; lowSprite once value <= lowThreshold
+//   Counter – `value` as decimal digits
+//   IconRow – `value` copies of `sprite`, `step` px apart
+//------------------------------------------------------------------------------
+struct HudWidget {
+    enum class Kind { Gauge, Counter, IconRow };
+
+    Kind        kind;
+    const int  *value;
+    int         shown = INT_MIN;   ///< value the surface currently holds
+    int         x = 0, y = 0, step = 0;
+    const Sprite *sprite    = nullptr;
+    const Sprite *lowSprite = nullptr;
+    int         lowThreshold = INT_MIN;
+    BitmapFont *font = nullptr;
+};
+
+//------------------------------------------------------------------------------
+// Hud: widgets rendered into one cached GAME_WIDTH x GAME_HEIGHT surface.
+// draw() re-renders the surface only when a bound value changed since the
+// last call; otherwise the whole HUD is a single texture draw.
+//------------------------------------------------------------------------------
+class Hud {
+public:
+    /// Drop all widgets (the surface is kept)
+    void clear() { widgets_.clear(); }
+
+    void addGauge(const int &value, const Sprite &pip, const Sprite &lowPip, int lowThreshold,
+                  int x, int y, int step);
+    void addCounter(const int &value, BitmapFont &font, int x, int y);
+    void addIconRow(const int &value, const Sprite &icon, int x, int y, int step);
+
+    /// Re-render the surface if any bound value changed, then draw it
+    void draw(Platform &platform);
+
+    /// Free the surface (before the platform goes away)
+    void release(Platform &platform);
+
+private:
+    void drawWidgets();
+
+    std::vector<HudWidget>  widgets_;
+    TextureHandle           surface_{};
+    bool                    composed_ = false;  ///< surface_ matches every widget's `shown`
+};
+
+#endif
@@ -0,0 +1,207 @@
+// main.cpp
+
+#include "game_handler.hpp"
+#include "software_platform.hpp"
+#include "frame_capture.hpp"
+#include "rollback_session.hpp"
+#ifdef KUNGFU_RAYLIB
+#include "raylib_platform.hpp"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+// --------------------------------------------------------------------------------------
+// Entry point: pick a backend, create a Game instance, hand control to run()
+//     kungfu [--software <frames>] [--upscale <filter>] [--capture <file.y4m>]
+//            [--record <file> | --replay <file> [--seek <tick>]]
+//            [--versus <port> | --versus <host>:<port>] [--netsim <lag>/<jitter>/<loss>]
+//            [--runahead <frames>] [--rewind <seconds>]
+//
+// --software renders <frames> frames on the CPU without a window (the only
+// backend when built without raylib), then writes the last one to
+// SOFTWARE_FRAME_FILE.
+// --upscale presents frames through a CPU pixel-art scaler: nearest, scale2x,
+// scale3x or xbr (see upscaler.hpp).
+// --capture writes every native frame to a Y4M video on a background thread
+// (see frame_capture.hpp). In the window, frames the writer cannot keep up
+// with are dropped and counted; --software runs wait for it instead.
+// --seek starts the replay at <tick> (negative: that many ticks before its
+// end) from the nearest keyframe in the file (see Game::seekReplay).
+// --versus plays two players over UDP with rollback (see rollback_session.hpp):
+// a port waits for the enemy player there, host:port joins as the enemy.
+// --netsim delays (ms), jitters (ms) and drops (%) this side's packets.
+// --runahead shows the simulation <frames> ticks ahead of the real one, which
+// takes that much off the input lag (local play only, see Game::setRunAhead).
+// --rewind keeps the last <seconds> of play; holding Backspace steps back
+// through them (practice, not while recording or replaying: see Game::setRewind).
+// Without it no history is kept.
+// --------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    unsigned long softwareFrames = 0;
+    const char   *recordPath = nullptr;
+    const char   *replayPath = nullptr;
+    const char   *upscale    = nullptr;
+    const char   *capturePath = nullptr;
+    const char   *versus     = nullptr;
+    const char   *netsim     = nullptr;
+    int           runAhead   = 0;
+    const char   *rewind     = nullptr;
+    const char   *seek       = nullptr;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if      (std::strcmp(argv[i], "--software") == 0) softwareFrames = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--record") == 0)   recordPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--replay") == 0)   replayPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--upscale") == 0)  upscale    = argv[i + 1];
+        else if (std::strcmp(argv[i], "--capture") == 0)  capturePath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--versus") == 0)   versus     = argv[i + 1];
+        else if (std::strcmp(argv[i], "--netsim") == 0)   netsim     = argv[i + 1];
+        else if (std::strcmp(argv[i], "--runahead") == 0) runAhead   = std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--rewind") == 0)   rewind     = argv[i + 1];
+        else if (std::strcmp(argv[i], "--seek") == 0)     seek       = argv[i + 1];
+    }
+
+    NetConditions conditions;
+    if (netsim != nullptr && !parseNetConditions(netsim, conditions))
+    {
+        std::fprintf(stderr, "bad --netsim %s, expected <lag ms>/<jitter ms>/<loss %%>\n", netsim);
+        return EXIT_FAILURE;
+    }
+
+    UpscaleFilter filter = UpscaleFilter::Nearest;
+    if (upscale != nullptr && !parseUpscaleFilter(upscale, filter))
+    {
+        std::fprintf(stderr, "unknown upscale filter %s\n", upscale);
+        return EXIT_FAILURE;
+    }
+
+#ifdef KUNGFU_RAYLIB
+    const bool software = softwareFrames != 0;
+#else
+    const bool software = true;
+    if (softwareFrames == 0) softwareFrames = SOFTWARE_DEFAULT_FRAMES;
+#endif
+
+    std::unique_ptr<SoftwarePlatform> cpu;
+    std::unique_ptr<Platform>         platform;
+#ifdef KUNGFU_RAYLIB
+    RaylibPlatform                   *window = nullptr;
+#endif
+    if (software)
+    {
+        cpu = std::make_unique<SoftwarePlatform>(softwareFrames);
+        if (upscale != nullptr) cpu->setPresentFilter(filter, PRESENT_NEAREST_FACTOR);
+    }
+#ifdef KUNGFU_RAYLIB
+    else
+    {
+        platform = std::make_unique<RaylibPlatform>();
+        window   = static_cast<RaylibPlatform*>(platform.get());
+        if (upscale != nullptr) window->setPresentFilter(filter, PRESENT_NEAREST_FACTOR);
+    }
+#endif
+
+    Game game(cpu ? *cpu : *platform);
+    game.setRunAhead(runAhead);
+    if (rewind != nullptr) game.setRewind(std::atoi(rewind));  // opt-in: no history otherwise
+
+    UdpTransport                      udp;
+    std::unique_ptr<SimulatedNetwork> lossy;
+    std::unique_ptr<RollbackSession>  session;
+    if (versus != nullptr)
+    {
+        const char *colon = std::strrchr(versus, ':');
+        const bool  host  = colon == nullptr;
+        const auto  port  = std::uint16_t(std::strtoul(host ? versus : colon + 1, nullptr, 10));
+        if (!(host ? udp.listen(port) : udp.connect(std::string(versus, colon), port)))
+        {
+            std::fprintf(stderr, "cannot open versus socket %s\n", versus);
+            return EXIT_FAILURE;
+        }
+        NetTransport *link = &udp;
+        if (netsim != nullptr)
+        {
+            lossy = std::make_unique<SimulatedNetwork>(udp, conditions, game.seed);
+            link  = lossy.get();
+        }
+        session = std::make_unique<RollbackSession>(game, *link, host ? 0 : 1);
+        game.setNetplay(session.get());
+        if (host) std::printf("versus: waiting for the enemy player on port %u\n", unsigned(port));
+        else      std::printf("versus: joining %s as the enemy\n", versus);
+    }
+    else if (recordPath != nullptr)
+    {
+        game.recordReplay(recordPath);
+    }
+    else if (replayPath != nullptr)
+    {
+        if (!game.playReplay(replayPath))
+        {
+            std::fprintf(stderr, "cannot read replay %s, playing live\n", replayPath);
+        }
+        else if (seek != nullptr)
+        {
+            const long long ticks  = game.replay.tickCount();
+            long long       target = std::atoll(seek);
+            if (target < 0) target += ticks;
+            target = std::clamp(target, 0LL, ticks);
+            if (!game.seekReplay(std::uint32_t(target)))
+                std::fprintf(stderr, "replay %s has no keyframes to seek with, playing from the start\n", replayPath);
+        }
+    }
+
+    // The window is open now, so its present rate is known
+    FrameCapture capture;
+    if (capturePath != nullptr)
+    {
+        int fps = TARGET_FPS;
+#ifdef KUNGFU_RAYLIB
+        if (window != nullptr) fps = window->presentRate();
+#endif
+        auto overflow = cpu ? FrameCapture::Overflow::Wait : FrameCapture::Overflow::Drop;
+        if (!capture.open(capturePath, GAME_WIDTH, GAME_HEIGHT, fps, CAPTURE_SLOTS, overflow))
+            std::fprintf(stderr, "cannot write capture %s\n", capturePath);
+        else if (cpu) cpu->setCapture(&capture);
+#ifdef KUNGFU_RAYLIB
+        else          window->setCapture(&capture);
+#endif
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    game.run();
+
+    if (session)
+    {
+        const NetplayStats &net = session->stats();
+        std::printf("versus: %d frames, %llu rollbacks (longest %d), %llu frames resimulated, "
+                    "%llu ticks waiting, %llu checksums compared, %s\n",
+                    session->frame(), (unsigned long long)net.rollbacks, net.maxDepth,
+                    (unsigned long long)net.resimulated, (unsigned long long)net.stalls,
+                    (unsigned long long)net.checksums, net.desyncFrame < 0 ? "in sync" : "DESYNC");
+    }
+
+    if (capture.isOpen())
+    {
+        capture.close();
+        std::printf("capture: wrote %llu of %llu frames to %s (%llu dropped)\n",
+                    (unsigned long long)capture.written(), (unsigned long long)capture.submitted(),
+                    capturePath, (unsigned long long)capture.dropped());
+    }
+
+    if (cpu)
+    {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("software: %lu frames in %.2f s (%.0f fps)\n",
+                    cpu->frames, seconds, seconds > 0 ? cpu->frames / seconds : 0.0);
+        if (cpu->savePpm(SOFTWARE_FRAME_FILE))
+            std::printf("software: wrote %s\n", SOFTWARE_FRAME_FILE);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+//------------------------------------------------------------------------------
+// MappedFile: a whole file mapped read-only (mmap / MapViewOfFile). Pages are
+// read in by the OS as they are first touched, so opening is cheap however
+// large the file is.
+//------------------------------------------------------------------------------
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile &&other) noexcept { swap(other); }
+    MappedFile& operator=(MappedFile &&other) noexcept {
+        if (this != &other) { close(); swap(other); }
+        return *this;
+    }
+
+    /// Map `path`. False if missing or empty.
+    bool open(const std::string &path);
+    void close();
+    inline bool isOpen() const { return base_ != nullptr; }
+
+    inline const std::uint8_t* data() const { return base_; }
+    inline std::size_t         size() const { return size_; }
+
+private:
+    void swap(MappedFile &other) noexcept {
+        std::swap(base_, other.base_);
+        std::swap(size_, other.size_);
+#ifdef _WIN32
+        std::swap(file_, other.file_);
+        std::swap(mapping_, other.mapping_);
+#endif
+    }
+
+    const std::uint8_t *base_ = nullptr;
+    std::size_t         size_ = 0;
+#ifdef _WIN32
+    void               *file_    = nullptr;
+    void               *mapping_ = nullptr;
+#endif
+};
+
+#endif
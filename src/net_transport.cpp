@@ -0,0 +1,229 @@
+// net_transport.cpp
+#include "net_transport.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX  // keep std::min usable
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------
+// UDP
+//------------------------------------------------------------------------------
+namespace {
+#ifdef _WIN32
+    using Socket     = SOCKET;
+    using SocketSize = int;  // Winsock takes int lengths
+
+    /// WSAStartup once per process, WSACleanup at exit
+    bool startNetworking()
+    {
+        static const struct Winsock {
+            bool ok;
+            Winsock()  { WSADATA data; ok = ::WSAStartup(MAKEWORD(2, 2), &data) == 0; }
+            ~Winsock() { if (ok) ::WSACleanup(); }
+        } winsock;
+        return winsock.ok;
+    }
+
+    inline void closeSocket(Socket s) { ::closesocket(s); }
+
+    inline bool makeNonBlocking(Socket s)
+    {
+        u_long on = 1;
+        return ::ioctlsocket(s, FIONBIO, &on) == 0;
+    }
+#else
+    using Socket     = int;
+    using SocketSize = std::size_t;
+
+    inline bool startNetworking()     { return true; }
+    inline void closeSocket(Socket s) { ::close(s); }
+
+    inline bool makeNonBlocking(Socket s)
+    {
+        return ::fcntl(s, F_SETFL, ::fcntl(s, F_GETFL, 0) | O_NONBLOCK) == 0;
+    }
+#endif
+
+    // UdpTransport::socket_ holds either handle; INVALID_SOCKET and a
+    // failed socket() both come out as -1
+    inline Socket        toSocket(std::intptr_t handle) { return Socket(handle); }
+    inline std::intptr_t toHandle(Socket s)             { return std::intptr_t(s); }
+
+    std::intptr_t openSocket(std::uint16_t port)
+    {
+        if (!startNetworking()) return -1;
+        const Socket s = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (toHandle(s) < 0) return -1;
+
+        sockaddr_in local{};
+        local.sin_family      = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        local.sin_port        = htons(port);
+        if (::bind(s, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0
+            || !makeNonBlocking(s))
+        {
+            closeSocket(s);
+            return -1;
+        }
+        return toHandle(s);
+    }
+}
+
+bool UdpTransport::listen(std::uint16_t port)
+{
+    close();
+    socket_    = openSocket(port);
+    listening_ = true;
+    return socket_ >= 0;
+}
+
+bool UdpTransport::connect(const std::string &host, std::uint16_t port)
+{
+    close();
+    if (!startNetworking()) return false;
+    addrinfo hints{};
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo *found = nullptr;
+    if (::getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || found == nullptr) return false;
+    peerAddress_ = reinterpret_cast<const sockaddr_in*>(found->ai_addr)->sin_addr.s_addr;
+    ::freeaddrinfo(found);
+
+    peerPort_ = htons(port);
+    hasPeer_  = true;
+    socket_   = openSocket(0);  // any local port
+    return socket_ >= 0;
+}
+
+void UdpTransport::close()
+{
+    if (socket_ >= 0) closeSocket(toSocket(socket_));
+    socket_    = -1;
+    listening_ = hasPeer_ = false;
+}
+
+bool UdpTransport::send(const void *data, std::size_t size)
+{
+    if (socket_ < 0 || !hasPeer_) return false;
+    sockaddr_in to{};
+    to.sin_family      = AF_INET;
+    to.sin_addr.s_addr = peerAddress_;
+    to.sin_port        = peerPort_;
+    const auto sent = ::sendto(toSocket(socket_), static_cast<const char*>(data), SocketSize(size), 0,
+                               reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+    return sent >= 0 && std::size_t(sent) == size;
+}
+
+std::size_t UdpTransport::receive(void *buffer, std::size_t capacity)
+{
+    while (socket_ >= 0)
+    {
+        sockaddr_in from{};
+        socklen_t   fromSize = sizeof(from);
+        const auto n = ::recvfrom(toSocket(socket_), static_cast<char*>(buffer), SocketSize(capacity), 0,
+                                  reinterpret_cast<sockaddr*>(&from), &fromSize);
+        if (n <= 0) return 0;  // nothing waiting (EWOULDBLOCK / WSAEWOULDBLOCK) or an error
+
+        if (listening_)
+        {
+            hasPeer_     = true;
+            peerAddress_ = from.sin_addr.s_addr;
+            peerPort_    = from.sin_port;
+        }
+        else if (from.sin_addr.s_addr != peerAddress_ || from.sin_port != peerPort_)
+        {
+            continue;  // not from the host
+        }
+        return std::size_t(n);
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// Loopback
+//------------------------------------------------------------------------------
+void LoopbackTransport::link(LoopbackTransport &a, LoopbackTransport &b)
+{
+    a.peer_ = &b;
+    b.peer_ = &a;
+}
+
+bool LoopbackTransport::send(const void *data, std::size_t size)
+{
+    if (peer_ == nullptr) return false;
+    const auto *bytes = static_cast<const std::uint8_t*>(data);
+    peer_->inbox_.emplace_back(bytes, bytes + size);
+    return true;
+}
+
+std::size_t LoopbackTransport::receive(void *buffer, std::size_t capacity)
+{
+    if (inbox_.empty()) return 0;
+    const std::vector<std::uint8_t> &next = inbox_.front();
+    const std::size_t size = std::min(next.size(), capacity);
+    std::memcpy(buffer, next.data(), size);
+    inbox_.pop_front();
+    return size;
+}
+
+//------------------------------------------------------------------------------
+// Simulated network
+//------------------------------------------------------------------------------
+bool parseNetConditions(const char *text, NetConditions &out)
+{
+    NetConditions c;
+    double lossPercent = 0;
+    char   extra;
+    if (std::sscanf(text, "%lf/%lf/%lf%c", &c.lagMs, &c.jitterMs, &lossPercent, &extra) != 3
+        || c.lagMs < 0 || c.jitterMs < 0 || lossPercent < 0 || lossPercent > 100)
+        return false;
+    c.lossRate = lossPercent / 100.0;
+    out = c;
+    return true;
+}
+
+bool SimulatedNetwork::send(const void *data, std::size_t size)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    if (unit(rng_) < conditions_.lossRate)
+    {
+        dropped_++;
+        return true;  // "sent", then lost on the way
+    }
+    const double delayMs = conditions_.lagMs + conditions_.jitterMs * unit(rng_);
+    const auto  *bytes   = static_cast<const std::uint8_t*>(data);
+    pending_.push_back({ now_ + delayMs / 1000.0, std::vector<std::uint8_t>(bytes, bytes + size) });
+    return true;
+}
+
+void SimulatedNetwork::update(double now)
+{
+    now_ = now;
+
+    // due datagrams leave in order of arrival time, the rest wait
+    std::stable_sort(pending_.begin(), pending_.end(),
+                     [](const Pending &a, const Pending &b) { return a.due < b.due; });
+    std::size_t due = 0;
+    while (due < pending_.size() && pending_[due].due <= now)
+    {
+        inner_.send(pending_[due].bytes.data(), pending_[due].bytes.size());
+        due++;
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + std::ptrdiff_t(due));
+
+    inner_.update(now);
+}
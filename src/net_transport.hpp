@@ -0,0 +1,129 @@
+#ifndef _NET_TRANSPORT_H_
+#define _NET_TRANSPORT_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// NetTransport: unreliable, unordered datagrams to one peer - what UDP gives.
+//
+// RollbackSession only talks to this, so the same session code runs over a
+// real socket, over an in-process pair (tests, benchmarks) and through a
+// simulated bad network. Nothing here blocks.
+//------------------------------------------------------------------------------
+constexpr std::size_t MaxDatagramSize = 512;
+
+class NetTransport {
+public:
+    virtual ~NetTransport() = default;
+
+    /// Hand one datagram to the network (it may still be lost).
+    /// False if it could not be sent at all.
+    virtual bool send(const void *data, std::size_t size) = 0;
+
+    /// Copy the next waiting datagram into `buffer`: its size, 0 if none
+    virtual std::size_t receive(void *buffer, std::size_t capacity) = 0;
+
+    /// Called once per tick with the session clock in seconds; transports
+    /// that hold packets back deliver the ones that are due
+    virtual void update(double now) { (void)now; }
+};
+
+//------------------------------------------------------------------------------
+// UdpTransport: one non-blocking IPv4 UDP socket. The host binds a port and
+// answers whoever last sent it a datagram; the guest sends to a fixed address.
+// BSD sockets, or Winsock 2 on Windows (started on first use).
+//------------------------------------------------------------------------------
+class UdpTransport : public NetTransport {
+public:
+    UdpTransport() = default;
+    ~UdpTransport() override { close(); }
+    UdpTransport(const UdpTransport&) = delete;
+    UdpTransport& operator=(const UdpTransport&) = delete;
+
+    /// Host: accept a peer on `port`
+    bool listen(std::uint16_t port);
+    /// Guest: talk to `host` (name or dotted address) on `port`
+    bool connect(const std::string &host, std::uint16_t port);
+    void close();
+
+    inline bool isOpen() const { return socket_ >= 0; }
+
+    bool        send(const void *data, std::size_t size) override;
+    std::size_t receive(void *buffer, std::size_t capacity) override;
+
+private:
+    std::intptr_t socket_      = -1;  ///< file descriptor / SOCKET, -1 = closed
+    bool          listening_   = false;  ///< host: the peer is whoever writes to us
+    bool          hasPeer_     = false;
+    std::uint32_t peerAddress_ = 0;   ///< network byte order
+    std::uint16_t peerPort_    = 0;   ///< network byte order
+};
+
+//------------------------------------------------------------------------------
+// LoopbackTransport: one end of an in-process link. What one end sends, the
+// other receives on its next receive(), in order and without loss.
+//------------------------------------------------------------------------------
+class LoopbackTransport : public NetTransport {
+public:
+    LoopbackTransport() = default;
+    LoopbackTransport(const LoopbackTransport&) = delete;
+    LoopbackTransport& operator=(const LoopbackTransport&) = delete;
+
+    /// Connect two ends to each other
+    static void link(LoopbackTransport &a, LoopbackTransport &b);
+
+    bool        send(const void *data, std::size_t size) override;
+    std::size_t receive(void *buffer, std::size_t capacity) override;
+
+private:
+    LoopbackTransport                    *peer_ = nullptr;
+    std::deque<std::vector<std::uint8_t>> inbox_;
+};
+
+//------------------------------------------------------------------------------
+// SimulatedNetwork: wraps another transport and makes its outgoing datagrams
+// late, out of order and lossy. Wrap both peers' transports to degrade both
+// directions. Deterministic for a given seed.
+//------------------------------------------------------------------------------
+struct NetConditions {
+    double lagMs    = 0;  ///< one-way delay
+    double jitterMs = 0;  ///< extra delay, uniform in [0, jitterMs] (reorders)
+    double lossRate = 0;  ///< fraction of datagrams dropped, 0..1
+};
+
+/// Parse "<lag ms>/<jitter ms>/<loss %>", e.g. "60/20/5". False if malformed.
+bool parseNetConditions(const char *text, NetConditions &out);
+
+class SimulatedNetwork : public NetTransport {
+public:
+    SimulatedNetwork(NetTransport &inner, const NetConditions &conditions, std::uint32_t seed = 1)
+        : inner_(inner), conditions_(conditions), rng_(seed) {}
+
+    bool        send(const void *data, std::size_t size) override;
+    std::size_t receive(void *buffer, std::size_t capacity) override { return inner_.receive(buffer, capacity); }
+    void        update(double now) override;
+
+    inline std::uint64_t dropped() const { return dropped_; }
+
+private:
+    struct Pending {
+        double                    due;
+        std::vector<std::uint8_t> bytes;
+    };
+
+    NetTransport         &inner_;
+    NetConditions         conditions_;
+    std::mt19937          rng_;
+    double                now_     = 0;
+    std::uint64_t         dropped_ = 0;
+    std::vector<Pending>  pending_;
+};
+
+#endif
@@ -0,0 +1,147 @@
+// particle_system.cpp
+#include "particle_system.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr std::uint32_t RandomSeed = 0x9E3779B9u;
+
+    constexpr float Gravity   = 0.18f;  ///< px per tick per tick
+    constexpr float Drag      = 0.94f;  ///< horizontal speed kept per tick
+    constexpr float MinLife   = 10.0f;  ///< ticks
+    constexpr float LifeRange = 14.0f;
+
+    // Spark texture: SparkColors frames of SparkSize x SparkSize, side by side.
+    // A spark cools down one colour every ColorTicks of its remaining life.
+    constexpr int   SparkSize   = 2;
+    constexpr int   SparkColors = 4;
+    constexpr float ColorTicks  = 5.0f;
+    constexpr unsigned char SparkRgb[SparkColors][3] = {
+        { 200,  40,  20 },  // red, about to go out
+        { 255, 140,  30 },  // orange
+        { 255, 230,  80 },  // yellow
+        { 255, 255, 255 },  // white, fresh
+    };
+}
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+    : x_(capacity), y_(capacity), vx_(capacity), vy_(capacity), life_(capacity)
+    , random_(RandomSeed)
+{
+}
+
+float ParticleSystem::random()
+{
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 17;
+    random_ ^= random_ << 5;
+    return float(random_ >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::burst(float x, float y, int count, int dirX)
+{
+    for (int k = 0; k < count && count_ < capacity(); k++, count_++) {
+        const float speed = 1.0f + 2.0f * random();
+        const float side  = dirX != 0 ? float(dirX) : (random() < 0.5f ? -1.0f : 1.0f);
+        x_[count_]    = x;
+        y_[count_]    = y;
+        vx_[count_]   = side * speed * (0.3f + 0.7f * random());
+        vy_[count_]   = -speed * (0.5f + random());
+        life_[count_] = MinLife + LifeRange * random();
+    }
+}
+
+void ParticleSystem::update()
+{
+    float *x = x_.data(), *y = y_.data(), *vx = vx_.data(), *vy = vy_.data(), *life = life_.data();
+    const std::size_t n = count_;
+
+    // One pass: integrate each spark and write the survivors back, in order,
+    // from the front. `live` never passes `i`, so nothing unread is overwritten.
+    std::size_t live = 0, i = 0;
+#if defined(__SSE2__)
+    const __m128 gravity = _mm_set1_ps(Gravity);
+    const __m128 drag    = _mm_set1_ps(Drag);
+    const __m128 one     = _mm_set1_ps(1.0f);
+    const __m128 zero    = _mm_setzero_ps();
+    const __m128 bottom  = _mm_set1_ps(float(GAME_HEIGHT));
+    for (; i + 4 <= n; i += 4) {
+        const __m128 pvx = _mm_loadu_ps(vx + i);
+        const __m128 pvy = _mm_add_ps(_mm_loadu_ps(vy + i), gravity);
+        const __m128 lanes[5] = {
+            _mm_add_ps(_mm_loadu_ps(x + i), pvx),
+            _mm_add_ps(_mm_loadu_ps(y + i), pvy),
+            _mm_mul_ps(pvx, drag),
+            pvy,
+            _mm_sub_ps(_mm_loadu_ps(life + i), one),
+        };
+        const int alive = _mm_movemask_ps(_mm_and_ps(_mm_cmpgt_ps(lanes[4], zero),
+                                                     _mm_cmplt_ps(lanes[1], bottom)));
+        if (alive == 0xF) {  // the common case: all four survive
+            _mm_storeu_ps(x + live,    lanes[0]);
+            _mm_storeu_ps(y + live,    lanes[1]);
+            _mm_storeu_ps(vx + live,   lanes[2]);
+            _mm_storeu_ps(vy + live,   lanes[3]);
+            _mm_storeu_ps(life + live, lanes[4]);
+            live += 4;
+            continue;
+        }
+        alignas(16) float f[5][4];
+        for (int k = 0; k < 5; k++) _mm_store_ps(f[k], lanes[k]);
+        for (int k = 0; k < 4; k++) {
+            x[live] = f[0][k]; y[live] = f[1][k]; vx[live] = f[2][k]; vy[live] = f[3][k]; life[live] = f[4][k];
+            live += std::size_t((alive >> k) & 1);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        const float pvy = vy[i] + Gravity;
+        const float py  = y[i] + pvy;
+        const float pl  = life[i] - 1.0f;
+        x[live]    = x[i] + vx[i];
+        vx[live]   = vx[i] * Drag;
+        y[live]    = py;
+        vy[live]   = pvy;
+        life[live] = pl;
+        live += std::size_t((pl > 0.0f) & (py < float(GAME_HEIGHT)));
+    }
+    count_ = live;
+}
+
+void ParticleSystem::draw(Platform &platform)
+{
+    if (count_ == 0) return;
+    if (texture_.id == 0) {
+        unsigned char rgba[SparkColors * SparkSize * SparkSize * 4];
+        for (int py = 0; py < SparkSize; py++) {
+            for (int px = 0; px < SparkColors * SparkSize; px++) {
+                unsigned char *p = rgba + (py * SparkColors * SparkSize + px) * 4;
+                const unsigned char *c = SparkRgb[px / SparkSize];
+                p[0] = c[0]; p[1] = c[1]; p[2] = c[2]; p[3] = 255;
+            }
+        }
+        texture_ = platform.loadTextureFromPixels(SparkColors * SparkSize, SparkSize, rgba);
+    }
+
+    for (std::size_t i = 0; i < count_; i++) {
+        int color = int(life_[i] / ColorTicks);
+        if (color >= SparkColors) color = SparkColors - 1;
+        const Rect src = { float(color * SparkSize), 0, float(SparkSize), float(SparkSize) };
+        platform.drawTexture(texture_, src, std::floor(x_[i]), std::floor(y_[i]), DrawLayer::Effects);
+    }
+}
+
+void ParticleSystem::clear()
+{
+    count_  = 0;
+    random_ = RandomSeed;
+}
+
+void ParticleSystem::release(Platform &platform)
+{
+    if (texture_.id != 0) platform.unloadTexture(texture_);
+}
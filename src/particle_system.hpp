@@ -0,0 +1,59 @@
+#ifndef _PARTICLE_SYSTEM_H_
+#define _PARTICLE_SYSTEM_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "platform_handler.hpp"
+
+//------------------------------------------------------------------------------
+// ParticleSystem: hit sparks. A fixed-capacity pool stored as structure of
+// arrays (one array per field), so update() advances four particles per SSE
+// instruction and spawning never allocates: when the pool is full, extra
+// sparks are simply not spawned.
+//
+// Sparks are cosmetic. They draw from their own generator, not Game::rng, so
+// gameplay (and replays) are the same with or without them. Dead particles
+// are removed in order, which keeps the n-th live spark the same spark from
+// tick to tick (FramePacer blends draws by that rank).
+//------------------------------------------------------------------------------
+class ParticleSystem {
+public:
+    explicit ParticleSystem(std::size_t capacity);
+
+    /// Spawn up to `count` sparks at (x, y), thrown up and toward `dirX`
+    /// (-1 left, 0 both ways, 1 right)
+    void burst(float x, float y, int count, int dirX);
+
+    /// Advance every spark one tick and drop the ones that burnt out or fell
+    /// off the stage
+    void update();
+
+    /// Draw every live spark; the spark texture is created on first use
+    void draw(Platform &platform);
+
+    /// Kill every spark and restart the generator
+    void clear();
+
+    /// Free the spark texture (before the platform goes away)
+    void release(Platform &platform);
+
+    inline std::size_t size() const     { return count_; }
+    inline std::size_t capacity() const { return x_.size(); }
+
+private:
+    /// Uniform in [0, 1)
+    float random();
+
+    std::vector<float>  x_, y_;      ///< position, px
+    std::vector<float>  vx_, vy_;    ///< velocity, px per tick
+    std::vector<float>  life_;       ///< ticks left
+    std::size_t         count_ = 0;  ///< live sparks are [0, count_)
+    std::uint32_t       random_;     ///< xorshift32 state
+    TextureHandle       texture_{};  ///< one 2x2 frame per colour, hot to cold
+};
+
+#endif
@@ -0,0 +1,35 @@
+// platform_handler.cpp
+#include "platform_handler.hpp"
+
+#include <fstream>
+
+//------------------------------------------------------------------------------
+// NullPlatform
+//------------------------------------------------------------------------------
+void NullPlatform::endFrame()
+{
+    // "released" is only true for the frame right after a key goes up
+    prevKeys_ = keys_;
+    frames++;
+}
+
+bool NullPlatform::decodeImage(const std::string &path, PixelImage &out)
+{
+    // Only the size matters headless: read it from the PNG IHDR chunk
+    // (8-byte signature, 4-byte length, "IHDR", then big-endian w/h).
+    std::ifstream ifs(path, std::ios::binary);
+    unsigned char header[24] = {};
+    if (!ifs.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+
+    out.width  = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+    out.height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+    out.rgba.clear();
+    return true;
+}
+
+TextureHandle NullPlatform::loadTexture(const std::string &path)
+{
+    PixelImage img;
+    decodeImage(path, img);
+    return { nextTextureId_++, img.width, img.height };
+}
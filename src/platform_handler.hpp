@@ -0,0 +1,247 @@
+#ifndef _PLATFORM_H_
+#define _PLATFORM_H_
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdint>
+
+#include "settings.hpp"
+
+//------------------------------------------------------------------------------
+// Backend-neutral value types (no raylib in gameplay headers)
+//------------------------------------------------------------------------------
+struct Rect {
+    float x, y, width, height;
+};
+
+/// GPU (or CPU) resident image, owned by the Platform that created it.
+struct TextureHandle {
+    unsigned int id     = 0;  ///< backend-specific id, 0 = invalid
+    int          width  = 0;
+    int          height = 0;
+};
+
+struct SoundHandle { int id = -1; };  ///< index into the backend's sound table, -1 = none (playing it does nothing)
+struct MusicHandle { int id = -1; };  ///< index into the backend's music table, -1 = none
+
+/// Decoded image in CPU memory (tightly packed RGBA8)
+struct PixelImage {
+    int                        width  = 0;
+    int                        height = 0;
+    std::vector<unsigned char> rgba;
+};
+
+/// Decoded sound in CPU memory (interleaved PCM)
+struct PcmWave {
+    unsigned int               frameCount = 0;
+    unsigned int               sampleRate = 0;
+    unsigned int               sampleSize = 0;  ///< bits per sample
+    unsigned int               channels   = 0;
+    std::vector<unsigned char> samples;
+};
+
+/// Back-to-front draw order inside a frame. Draws are sorted by layer, then
+/// by texture (fewer texture switches); within one texture code order is kept.
+enum class DrawLayer : std::uint8_t {
+    Background = 0,  ///< stage art, title logos
+    Props,           ///< behind the fighters (level-3 chain)
+    Enemy,
+    Player,
+    Effects,         ///< hit sparks
+    HudBack,         ///< health bar frame
+    Hud,             ///< text, health pips, life icons
+    Count
+};
+
+//------------------------------------------------------------------------------
+// Logical keys used by the game (mapped to real keys by each backend)
+//------------------------------------------------------------------------------
+enum class Key : int {
+    Left = 0,
+    Right,
+    Up,
+    Down,
+    A,       ///< punch
+    S,       ///< kick
+    Enter,
+    Escape,
+    Count
+};
+
+constexpr int KeyCount = static_cast<int>(Key::Count);
+
+//------------------------------------------------------------------------------
+// InputSnapshot: everything one simulation tick can ask about the keyboard,
+// packed into a bitmask (bit k: key k held, bit KeyCount + k: key k released
+// since the previous tick). Recorded verbatim in replays.
+//------------------------------------------------------------------------------
+struct InputSnapshot {
+    std::uint16_t bits = 0;
+
+    inline bool down(Key key) const     { return bits & (1u << int(key)); }
+    inline bool released(Key key) const { return bits & (1u << (KeyCount + int(key))); }
+
+    inline void set(Key key, bool isDown, bool isReleased) {
+        if (isDown)     bits |= std::uint16_t(1u << int(key));
+        if (isReleased) bits |= std::uint16_t(1u << (KeyCount + int(key)));
+    }
+};
+
+static_assert(2 * KeyCount <= 16, "InputSnapshot holds two bits per key");
+
+/// Developer and practice hotkeys: not gameplay input, never recorded in replays
+enum class DebugKey : int {
+    DumpProfile = 0,  ///< write the profiler trace (F9)
+    Rewind,           ///< held: step the match backward (Backspace, see Game::setRewind)
+    Count
+};
+
+constexpr int DebugKeyCount = static_cast<int>(DebugKey::Count);
+
+//------------------------------------------------------------------------------
+// Platform: everything the game needs from the outside world
+// (window, input, drawing, audio). Gameplay code only talks to this.
+//------------------------------------------------------------------------------
+class Platform {
+public:
+    virtual ~Platform() = default;
+
+    // ----------------------------------------------------------------
+    // window & frame
+    virtual void openWindow(int width, int height, const char *title) = 0;
+    virtual void closeWindow() = 0;
+    virtual bool shouldClose() = 0;
+    /// Monotonic wall clock in seconds (drives the fixed-timestep loop)
+    virtual double now() = 0;
+
+    /// Start drawing into the GAME_WIDTH x GAME_HEIGHT frame
+    virtual void beginFrame() = 0;
+    /// Present the frame (scaled to the window) and poll input
+    virtual void endFrame() = 0;
+
+    // ----------------------------------------------------------------
+    // input
+    virtual bool isKeyDown(Key key) = 0;
+    virtual bool isKeyReleased(Key key) = 0;
+    /// True on the frame the debug key went down
+    virtual bool isDebugKeyPressed(DebugKey key) = 0;
+    /// True while the debug key is held
+    virtual bool isDebugKeyDown(DebugKey key) = 0;
+
+    // ----------------------------------------------------------------
+    // decoding (CPU only, must be safe to call from worker threads)
+    virtual bool decodeImage(const std::string &path, PixelImage &out) = 0;
+    virtual bool decodeWave(const std::string &path, PcmWave &out) = 0;
+
+    // ----------------------------------------------------------------
+    // textures & drawing
+    virtual TextureHandle loadTexture(const std::string &path) = 0;
+    /// Create a texture from tightly packed RGBA8 pixels (read once, not kept)
+    virtual TextureHandle loadTextureFromPixels(int width, int height, const void *rgba) = 0;
+    virtual void unloadTexture(TextureHandle &texture) = 0;
+
+    /// Off-screen texture to pre-composite static draws into ({} if unsupported).
+    /// Drawn like any texture, freed with unloadTexture.
+    virtual TextureHandle createRenderTarget(int width, int height) = 0;
+    /// Send draws into `target` (cleared to transparent) until endRenderTarget.
+    /// These draws happen immediately, never recorded or sorted.
+    virtual void beginRenderTarget(const TextureHandle &target) = 0;
+    virtual void endRenderTarget() = 0;
+
+    /// Draw `src` of `texture` at (x, y). A negative src width mirrors it.
+    /// `layer` orders the draw within the frame (see FramePacer); backends
+    /// that draw immediately ignore it.
+    virtual void drawTexture(const TextureHandle &texture, const Rect &src,
+                             float x, float y, DrawLayer layer) = 0;
+
+    // ----------------------------------------------------------------
+    // audio
+    virtual SoundHandle loadSound(const std::string &path) = 0;
+    /// Create a sound from raw interleaved PCM (copied)
+    virtual SoundHandle loadSoundFromPcm(unsigned int frameCount, unsigned int sampleRate,
+                                         unsigned int sampleSize, unsigned int channels,
+                                         const void *samples) = 0;
+    virtual void unloadSound(SoundHandle sound) = 0;
+    virtual void playSound(SoundHandle sound) = 0;
+
+    virtual MusicHandle loadMusic(const std::string &path) = 0;
+    /// Stream music from an encoded file in memory; `data` must outlive the music
+    virtual MusicHandle loadMusicFromMemory(const char *fileType, const void *data, int size) = 0;
+    virtual void unloadMusic(MusicHandle music) = 0;
+    virtual void playMusic(MusicHandle music) = 0;
+    virtual void updateMusic(MusicHandle music) = 0;
+    virtual void stopMusic(MusicHandle music) = 0;
+};
+
+//------------------------------------------------------------------------------
+// NullPlatform: headless backend. No window, no GPU, no audio device.
+// Texture sizes are read from the PNG headers so gameplay geometry matches
+// the real game; input is injected by the caller.
+//------------------------------------------------------------------------------
+class NullPlatform : public Platform {
+public:
+    void openWindow(int, int, const char *) override {}
+    void closeWindow() override {}
+    bool shouldClose() override { return closeRequested; }
+    /// Advances one TARGET_FPS tick per presented frame: headless runs are deterministic
+    double now() override { return double(frames) / TARGET_FPS; }
+
+    void beginFrame() override {}
+    void endFrame() override;
+
+    bool isKeyDown(Key key) override     { return keys_[int(key)]; }
+    bool isKeyReleased(Key key) override { return prevKeys_[int(key)] && !keys_[int(key)]; }
+    bool isDebugKeyPressed(DebugKey) override { return false; }
+    bool isDebugKeyDown(DebugKey key) override { return debugKeys_[int(key)]; }
+
+    /// Size only (from the PNG header), no pixels
+    bool decodeImage(const std::string &path, PixelImage &out) override;
+    bool decodeWave(const std::string &, PcmWave &) override { return true; }
+
+    TextureHandle loadTexture(const std::string &path) override;
+    TextureHandle loadTextureFromPixels(int width, int height, const void *) override {
+        return { nextTextureId_++, width, height };
+    }
+    void unloadTexture(TextureHandle &texture) override { texture = {}; }
+    TextureHandle createRenderTarget(int width, int height) override {
+        return { nextTextureId_++, width, height };
+    }
+    void beginRenderTarget(const TextureHandle &) override {}
+    void endRenderTarget() override {}
+    void drawTexture(const TextureHandle &, const Rect &, float, float, DrawLayer) override { drawCalls++; }
+
+    SoundHandle loadSound(const std::string &) override { return { soundCount_++ }; }
+    SoundHandle loadSoundFromPcm(unsigned int, unsigned int, unsigned int, unsigned int,
+                                 const void *) override { return { soundCount_++ }; }
+    void unloadSound(SoundHandle) override {}
+    void playSound(SoundHandle) override { soundsPlayed++; }
+
+    MusicHandle loadMusic(const std::string &) override { return { musicCount_++ }; }
+    MusicHandle loadMusicFromMemory(const char *, const void *, int) override { return { musicCount_++ }; }
+    void unloadMusic(MusicHandle) override {}
+    void playMusic(MusicHandle) override {}
+    void updateMusic(MusicHandle) override {}
+    void stopMusic(MusicHandle) override {}
+
+    /// Set the held state of a key for the next frame(s)
+    inline void setKeyDown(Key key, bool down) { keys_[int(key)] = down; }
+    inline void setDebugKeyDown(DebugKey key, bool down) { debugKeys_[int(key)] = down; }
+
+    bool          closeRequested = false;
+    unsigned long drawCalls      = 0;  ///< since construction
+    unsigned long soundsPlayed   = 0;
+    unsigned long frames         = 0;
+
+private:
+    std::array<bool, KeyCount>      keys_{};
+    std::array<bool, KeyCount>      prevKeys_{};
+    std::array<bool, DebugKeyCount> debugKeys_{};
+    unsigned int                    nextTextureId_ = 1;
+    int                             soundCount_    = 0;
+    int                             musicCount_    = 0;
+};
+
+#endif
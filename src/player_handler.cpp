@@ -1,6 +1,6 @@
 // player.cpp
 #include "player_handler.hpp"
-#include <raylib.h>
+#include "profiler.hpp"
 
 // Constructor: initialize fields via initializer list
 Player::Player(Game *gm)
@@ -28,8 +28,8 @@ Player::Player(Game *gm)
     , showHit_(false)
     , life_counter(0)
 {
-    // Override the “normal” player sprite’s frame speed
-    game_->sprites.at("player_default").setAnimationSpeed(kPlayerFrameRate);
+    // The walk cycle runs faster than the player_default sheet's own speed
+    walkAnim_.speed = kPlayerFrameRate;
 }
 
 void Player::clear() {
@@ -45,71 +45,136 @@ void Player::clear() {
     activateTime = 0;
     showHit_ = false;
     life_counter = 0;
-    // If flipped, unflip
-    if (isInverted) invertSprites();
+    // Face right again
+    isInverted = false;
 }
 
-void Player::invertSprites() {
-    // Flip all player sprites and the hit effect
-    for (auto &name : playerSprites) {
-        game_->sprites.at(name).invertHorizontally();
-    }
-    game_->sprites.at("effect_hit").invertHorizontally(); isInverted = !isInverted;
+//------------------------------------------------------------------------------
+// Snapshots (see sim_snapshot.hpp)
+//------------------------------------------------------------------------------
+void Player::capture(PlayerSnapshot &out) const {
+    out.frameCounter     = frameCounter_;
+    out.elapsedSeconds   = elapsedSeconds_;
+    out.x                = x;
+    out.oldX             = oldX;
+    out.y                = y;
+    out.lives            = lives;
+    out.health           = health;
+    out.bonusScore       = bonusScore;
+    out.lifeCounter      = life_counter;
+    out.activateTime     = activateTime;
+    out.currAction       = std::int32_t(currAction_);
+    out.prevAction       = std::int32_t(prevAction_);
+    out.jumpDrift        = std::int32_t(jumpDrift);
+    out.pauseTimer       = pauseTimer;
+    out.stunJumpTimer    = stunJumpTimer_;
+    out.jumpFrameCounter = jumpFrameCounter_;
+    out.jumpAcceleration = jumpAcceleration_;
+    out.controlsLocked   = controlsLocked;
+    out.canAttack        = canAttack;
+    out.attackActive     = attackActive;
+    out.isInverted       = isInverted;
+    out.isShaking        = isShaking;
+    out.shakeDirRight    = shakeDirRight;
+    out.showHit          = showHit_;
+    out.isFlyingKick     = isFlyingKick_;
+    out.canFlyKick       = canFlyKick_;
+    out.reserved[0] = out.reserved[1] = out.reserved[2] = 0;
+    out.walkAnim         = toSnapshot(walkAnim_);
+    out.defeatedAnim     = toSnapshot(defeatedAnim_);
+    out.hitAnim          = toSnapshot(hitAnim_);
+}
+
+void Player::restore(const PlayerSnapshot &in) {
+    frameCounter_     = in.frameCounter;
+    elapsedSeconds_   = in.elapsedSeconds;
+    x                 = in.x;
+    oldX              = in.oldX;
+    y                 = in.y;
+    lives             = in.lives;
+    health            = in.health;
+    bonusScore        = in.bonusScore;
+    life_counter      = in.lifeCounter;
+    activateTime      = in.activateTime;
+    currAction_       = PlayerAction(in.currAction);
+    prevAction_       = PlayerAction(in.prevAction);
+    jumpDrift         = JumpDrift(in.jumpDrift);
+    pauseTimer        = in.pauseTimer;
+    stunJumpTimer_    = in.stunJumpTimer;
+    jumpFrameCounter_ = in.jumpFrameCounter;
+    jumpAcceleration_ = in.jumpAcceleration;
+    controlsLocked    = in.controlsLocked != 0;
+    canAttack         = in.canAttack != 0;
+    attackActive      = in.attackActive != 0;
+    isInverted        = in.isInverted != 0;
+    isShaking         = in.isShaking != 0;
+    shakeDirRight     = in.shakeDirRight != 0;
+    showHit_          = in.showHit != 0;
+    isFlyingKick_     = in.isFlyingKick != 0;
+    canFlyKick_       = in.canFlyKick != 0;
+    walkAnim_         = fromSnapshot(in.walkAnim);
+    defeatedAnim_     = fromSnapshot(in.defeatedAnim);
+    hitAnim_          = fromSnapshot(in.hitAnim);
+}
+
+void Player::drawPose(SpriteId id) {
+    game_->sprite(id).drawFrame(0, x, y, isInverted);
 }
 
 void Player::play() {
+    PROFILE_ZONE("Player::play");
     // Motion‐shake effect
     if (isShaking) {
         x += shakeDirRight ? kPlayerShakeForce : -kPlayerShakeForce;
         shakeDirRight = !shakeDirRight;
     }
-    // Update every sprite's position
-    for (auto &name : playerSprites) {
-        auto &spr = game_->sprites.at(name);
-        spr.x = x;
-        spr.y = y;
+    // Animated poses follow the player and face the same way
+    for (SpriteAnim *anim : { &walkAnim_, &defeatedAnim_ }) {
+        anim->x       = x;
+        anim->y       = y;
+        anim->flipped = isInverted;
     }
 
     // Draw based on currentMovement
-    auto &normal = game_->sprites.at("player_default");
+    auto &normal = game_->sprite(SpriteId::player_default);
     switch (currAction_) {
         case PlayerAction::WalkLeft:
         case PlayerAction::WalkRight:
-            normal._isPaused = game_->playState->renderEnemyHit;
-            normal.updateAndDraw();
+            walkAnim_.paused = game_->playState->renderEnemyHit;
+            normal.updateAndDraw(walkAnim_);
             break;
         case PlayerAction::PunchStand:
-            game_->sprites.at("player_punch_stand").draw();
+            drawPose(SpriteId::player_punch_stand);
             break;
         case PlayerAction::PunchCrouch:
-            game_->sprites.at("player_punch_crouch").draw();
+            drawPose(SpriteId::player_punch_crouch);
             break;    
         case PlayerAction::Crouch:
         case PlayerAction::JumpUp:
         case PlayerAction::JumpDown:
             if (isFlyingKick_)
-                game_->sprites.at("player_kick_fly").draw();
+                drawPose(SpriteId::player_kick_fly);
             else
-                game_->sprites.at("player_crouch").draw();
+                drawPose(SpriteId::player_crouch);
             break;
         case PlayerAction::DefaultHold:
-            normal.drawFrame(1);
+            normal.drawFrame(1, x, y, isInverted);
             break;
         case PlayerAction::KickStand:
-            game_->sprites.at("player_kick_stand").draw();
+            drawPose(SpriteId::player_kick_stand);
             break;
         case PlayerAction::KickHigh:
-            game_->sprites.at("player_kick_high").draw();
+            drawPose(SpriteId::player_kick_high);
             break;    
         case PlayerAction::KickCrouch:
-            game_->sprites.at("player_kick_crouch").draw();
+            drawPose(SpriteId::player_kick_crouch);
             break;
         case PlayerAction::Smile:
-            game_->sprites.at("player_smile").draw();
+            drawPose(SpriteId::player_smile);
             break;
         case PlayerAction::Defeated:
-            if (game_->sprites.at("player_defeated").updateAndDraw()) {
-                PlaySound(game_->sounds.at("twitch_feet"));
+            if (game_->sprite(SpriteId::player_defeated).updateAndDraw(defeatedAnim_)) {
+                game_->platform.playSound(game_->sound(SoundId::twitch_feet));
                 if (++life_counter == 3) {
                     setMovement(14);
                     game_->playState->enemyEndState = EnemyEndSequence::Transition;
@@ -117,21 +182,22 @@ void Player::play() {
             }
             break;    
         case PlayerAction::VeryDefeated:
-            game_->sprites.at("player_defeated").drawFrame(0);
+            drawPose(SpriteId::player_defeated);
             break;
         default:  // PlayerAction::Default
-            normal.drawFrame(0);
+            drawPose(SpriteId::player_default);
     }
 
     // Draw hit effect if needed
     if (showHit_) {
-        game_->sprites.at("effect_hit").draw();
+        hitAnim_.flipped = isInverted;
+        game_->sprite(SpriteId::effect_hit).draw(hitAnim_);
     }
 
     // Auto‐flip to face enemy if not mid‐air attack
     if (!isFlyingKick_ && game_->playState->endState <= EndSequence::Start) {
         bool shouldFlip = (game_->playState->enemyX < x) != isInverted;
-        if (shouldFlip) invertSprites();
+        if (shouldFlip) flip();
     }
 }
 
@@ -144,7 +210,7 @@ void Player::onTimeTick() {
                 pauseTimer       = 0;
                 activateTime   = 0;attackActive = true;
                 // If they were holding down, stay crouched
-                if (IsKeyDown(KEY_DOWN) && prevAction_ == PlayerAction::Crouch)
+                if (game_->platform.isKeyDown(Key::Down) && prevAction_ == PlayerAction::Crouch)
                     setMovement(4);
                 else
                     setMovement(0);
@@ -165,6 +231,8 @@ void Player::setMovement(int move) {
     if (currAction_ == PlayerAction::Defeated && move == 0) return;
     prevAction_    = currAction_;
     currAction_ = static_cast<PlayerAction>(move);
+    // Lying down always starts from the first frame
+    if (currAction_ == PlayerAction::Defeated) defeatedAnim_.reset();
 }
 
 void Player::handleInput() {
@@ -173,14 +241,14 @@ void Player::handleInput() {
         || game_->playState->renderEnemyHit || game_->playState->pauseMovement)
         return;
 
-    bool left  = IsKeyDown(KEY_LEFT), right = IsKeyDown(KEY_RIGHT);
+    bool left  = game_->platform.isKeyDown(Key::Left), right = game_->platform.isKeyDown(Key::Right);
 
     // Horizontal movement
     if (x > StageBoundary && left) {
         setMovement(2);
         x -= kPlayerSpeed;
     }
-    else if (x < GAME_WIDTH - StageBoundary - game_->sprites.at("player_default").getTexture().width/2 && right) {
+    else if (x < GAME_WIDTH - StageBoundary - game_->sprite(SpriteId::player_default).getWidth()/2 && right) {
         setMovement(3);
         x += kPlayerSpeed;
     }
@@ -190,12 +258,12 @@ void Player::handleInput() {
     }
 
     // Crouch
-    if (IsKeyDown(KEY_DOWN)) {
+    if (game_->platform.isKeyDown(Key::Down)) {
         setMovement(4);
     }
 
     // Jump
-    if (IsKeyDown(KEY_UP)) {
+    if (game_->platform.isKeyDown(Key::Up)) {
         jumpDrift = left ? JumpDrift::LeftDrift
                      : right ? JumpDrift::RightDrift
                              : JumpDrift::NoneDrift;
@@ -215,20 +283,20 @@ void Player::handleInput() {
     };
 
     // Three attack types
-    doAttack(IsKeyDown(KEY_A) && canAttack,
-             IsKeyDown(KEY_DOWN) ? 6 : 5);
-    doAttack(IsKeyDown(KEY_S) && canAttack && (left||right),
+    doAttack(game_->platform.isKeyDown(Key::A) && canAttack,
+             game_->platform.isKeyDown(Key::Down) ? 6 : 5);
+    doAttack(game_->platform.isKeyDown(Key::S) && canAttack && (left||right),
              9);
-    doAttack(IsKeyDown(KEY_S) && canAttack,
-             IsKeyDown(KEY_DOWN) ? 8 : 7);
+    doAttack(game_->platform.isKeyDown(Key::S) && canAttack,
+             game_->platform.isKeyDown(Key::Down) ? 8 : 7);
 
     // Release A/S to re‐enable next attack
-    if ((IsKeyReleased(KEY_A) || IsKeyReleased(KEY_S)) && !attackActive && !showHit_) {
+    if ((game_->platform.isKeyReleased(Key::A) || game_->platform.isKeyReleased(Key::S)) && !attackActive && !showHit_) {
         activateTime   = 0; attackActive = true;
     }
 
     // Mid‐air flying kick
-    if (IsKeyDown(KEY_S) && canFlyKick_
+    if (game_->platform.isKeyDown(Key::S) && canFlyKick_
         && (currAction_ == PlayerAction::JumpUp || currAction_ == PlayerAction::JumpDown)
         && y <= (kPlayerJumpHeight + 23))
     {
@@ -252,7 +320,7 @@ void Player::processJump() {
                 x -= kPlayerJumpSpeed;
             }
             else if (jumpDrift == JumpDrift::RightDrift
-                && x < GAME_WIDTH - StageBoundary - game_->sprites.at("player_default").getTexture().width/2)
+                && x < GAME_WIDTH - StageBoundary - game_->sprite(SpriteId::player_default).getWidth()/2)
             {
                 x += kPlayerJumpSpeed;
             }
@@ -318,16 +386,18 @@ void Player::processCollision() {
 
     // AABB test
     if (pX > eX+eW-1 || eX > pX+pW-1 || pY > eY+eH-1 || eY > pY+pH-1) {
-        PlaySound(game_->sounds.at("attack"));
+        game_->platform.playSound(game_->sound(SoundId::attack));
         return;
     }
 
     // Hit!
-    PlaySound(game_->sounds.at("collision"));
+    game_->platform.playSound(game_->sound(SoundId::collision));
     showHit_            = true;
     game_->score       += bonus;
-    game_->sprites.at("effect_hit").x = pX;
-    game_->sprites.at("effect_hit").y = pY;
+    hitAnim_.x          = pX;
+    hitAnim_.y          = pY;
+    if (!game_->outputMuted(Mute::Sounds))
+        st->particles.burst(float(pX + pW / 2), float(pY + pH / 2), HIT_SPARKS, isInverted ? -1 : 1);
     st->haltTime       = 0;
     st->pauseMovement  = true;
 }
@@ -5,6 +5,7 @@
 
 #include "game_handler.hpp"
 #include "other.hpp"
+#include "sim_snapshot.hpp"
 #include <vector>
 #include <string>
 
@@ -76,10 +77,14 @@ public:
     /// Update & draw the player each frame
     void play(); 
 
-    /// Invert all player sprites horizontally
-    void invertSprites(); 
+    /// Face the other way (every pose is drawn mirrored while isInverted)
+    inline void flip() { isInverted = !isInverted; }
 
-    /// Change to a new action (resets animation frame)
+    /// Everything play() and the input/jump/collision handlers carry between ticks
+    void capture(PlayerSnapshot &out) const;
+    void restore(const PlayerSnapshot &in);
+
+    /// Change to a new action (Defeated restarts its animation)
     /// @param action  new player action
     void setMovement(int action); 
 
@@ -143,8 +148,13 @@ private:
     bool            isFlyingKick_{false};
     bool            canFlyKick_{true};
 
-    /// Update all sprite positions to (x_, y_)
-    void updateSpritePositions_(); 
+    // animation cursors into the shared player sheets
+    SpriteAnim      walkAnim_{};       ///< player_default walk cycle
+    SpriteAnim      defeatedAnim_{};   ///< player_defeated twitching feet
+    SpriteAnim      hitAnim_{};        ///< effect_hit, placed on a landed attack
+
+    /// Draw frame 0 of a single-pose sheet where the player stands
+    void drawPose(SpriteId id);
 };
 
 //------------------------------------------------------------------------------
@@ -179,11 +189,4 @@ const CollisionInfo kCollisionBody = {
 };
 
 
-//------------------------------------------------------------------------------
-// Player sprite names
-//------------------------------------------------------------------------------
-const vector<string> playerSprites = {
-    "player_default","player_crouch","player_kick_stand","player_kick_crouch","player_punch_stand"
-    ,"player_punch_crouch","player_kick_fly","player_kick_high","player_defeated","player_smile"
-};
 #endif
\ No newline at end of file
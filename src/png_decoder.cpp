@@ -0,0 +1,329 @@
+// png_decoder.cpp
+#include "png_decoder.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+    //--------------------------------------------------------------------------
+    // Inflate (RFC 1951), canonical Huffman decoding one bit at a time.
+    // Sprite sheets are small; simplicity beats speed here.
+    //--------------------------------------------------------------------------
+    constexpr int MaxCodeBits = 15;
+
+    struct Huffman {
+        short counts[MaxCodeBits + 1];  ///< codes of each length
+        short symbols[288];             ///< symbols ordered by code
+    };
+
+    class Inflater {
+    public:
+        Inflater(const unsigned char *in, std::size_t size, std::vector<unsigned char> &out)
+            : in_(in), size_(size), out_(out) {}
+
+        bool run()
+        {
+            int last;
+            do {
+                last = bits(1);
+                int type = bits(2);
+                bool ok = type == 0 ? stored()
+                        : type == 1 ? fixed()
+                        : type == 2 ? dynamic()
+                        : false;
+                if (!ok || overrun_) return false;
+            } while (!last);
+            return true;
+        }
+
+    private:
+        int bits(int need)
+        {
+            long value = bitBuf_;
+            while (bitCount_ < need) {
+                if (pos_ >= size_) { overrun_ = true; return 0; }
+                value |= long(in_[pos_++]) << bitCount_;
+                bitCount_ += 8;
+            }
+            bitBuf_    = int(value >> need);
+            bitCount_ -= need;
+            return int(value & ((1L << need) - 1));
+        }
+
+        bool stored()
+        {
+            bitBuf_ = bitCount_ = 0;  // byte aligned from here
+            if (pos_ + 4 > size_) return false;
+            unsigned len = in_[pos_] | (in_[pos_ + 1] << 8);
+            unsigned inv = in_[pos_ + 2] | (in_[pos_ + 3] << 8);
+            pos_ += 4;
+            if (len != (~inv & 0xFFFF) || pos_ + len > size_) return false;
+            out_.insert(out_.end(), in_ + pos_, in_ + pos_ + len);
+            pos_ += len;
+            return true;
+        }
+
+        int decode(const Huffman &h)
+        {
+            int code = 0, first = 0, index = 0;
+            for (int len = 1; len <= MaxCodeBits; len++) {
+                code |= bits(1);
+                int count = h.counts[len];
+                if (code - count < first) return h.symbols[index + (code - first)];
+                index += count;
+                first += count;
+                first <<= 1;
+                code  <<= 1;
+                if (overrun_) return -1;
+            }
+            return -1;
+        }
+
+        static bool build(Huffman &h, const short *lengths, int n)
+        {
+            std::memset(h.counts, 0, sizeof(h.counts));
+            for (int s = 0; s < n; s++) h.counts[lengths[s]]++;
+            if (h.counts[0] == n) return true;  // no codes: only valid if never used
+
+            int left = 1;
+            for (int len = 1; len <= MaxCodeBits; len++) {
+                left <<= 1;
+                left -= h.counts[len];
+                if (left < 0) return false;     // over-subscribed
+            }
+
+            short offs[MaxCodeBits + 1];
+            offs[1] = 0;
+            for (int len = 1; len < MaxCodeBits; len++) offs[len + 1] = short(offs[len] + h.counts[len]);
+            for (int s = 0; s < n; s++)
+                if (lengths[s] != 0) h.symbols[offs[lengths[s]]++] = short(s);
+            return true;
+        }
+
+        bool codes(const Huffman &lencode, const Huffman &distcode)
+        {
+            static const short lenBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                               35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            static const short lenExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            static const short distBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                                8193, 12289, 16385, 24577 };
+            static const short distExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+            for (;;) {
+                int symbol = decode(lencode);
+                if (symbol < 0) return false;
+                if (symbol < 256) { out_.push_back((unsigned char)symbol); continue; }
+                if (symbol == 256) return true;
+
+                symbol -= 257;
+                if (symbol >= 29) return false;
+                std::size_t len = std::size_t(lenBase[symbol] + bits(lenExtra[symbol]));
+
+                symbol = decode(distcode);
+                if (symbol < 0 || symbol >= 30) return false;
+                std::size_t dist = std::size_t(distBase[symbol] + bits(distExtra[symbol]));
+                if (dist > out_.size()) return false;
+
+                std::size_t from = out_.size() - dist;  // may overlap what it produces
+                for (std::size_t i = 0; i < len; i++) out_.push_back(out_[from + i]);
+            }
+        }
+
+        bool fixed()
+        {
+            static Huffman lencode, distcode;
+            static const bool built = [] {
+                short lengths[288];
+                int s = 0;
+                for (; s < 144; s++) lengths[s] = 8;
+                for (; s < 256; s++) lengths[s] = 9;
+                for (; s < 280; s++) lengths[s] = 7;
+                for (; s < 288; s++) lengths[s] = 8;
+                build(lencode, lengths, 288);
+                for (s = 0; s < 30; s++) lengths[s] = 5;
+                build(distcode, lengths, 30);
+                return true;
+            }();
+            (void)built;
+            return codes(lencode, distcode);
+        }
+
+        bool dynamic()
+        {
+            static const short order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+            short lengths[320];
+
+            int nlen  = bits(5) + 257;
+            int ndist = bits(5) + 1;
+            int ncode = bits(4) + 4;
+            if (nlen > 286 || ndist > 30) return false;
+
+            int index = 0;
+            for (; index < ncode; index++) lengths[order[index]] = short(bits(3));
+            for (; index < 19; index++)    lengths[order[index]] = 0;
+
+            Huffman lencode, distcode;
+            if (!build(lencode, lengths, 19)) return false;
+
+            for (index = 0; index < nlen + ndist;) {
+                int symbol = decode(lencode);
+                if (symbol < 0) return false;
+                if (symbol < 16) { lengths[index++] = short(symbol); continue; }
+
+                short len = 0;
+                int   repeat;
+                if (symbol == 16) {
+                    if (index == 0) return false;
+                    len    = lengths[index - 1];
+                    repeat = 3 + bits(2);
+                }
+                else if (symbol == 17) repeat = 3 + bits(3);
+                else                   repeat = 11 + bits(7);
+                if (index + repeat > nlen + ndist) return false;
+                while (repeat--) lengths[index++] = len;
+            }
+            if (lengths[256] == 0) return false;  // no end-of-block code
+
+            if (!build(lencode, lengths, nlen) || !build(distcode, lengths + nlen, ndist)) return false;
+            return codes(lencode, distcode);
+        }
+
+        const unsigned char        *in_;
+        std::size_t                 size_;
+        std::size_t                 pos_ = 0;
+        int                         bitBuf_ = 0, bitCount_ = 0;
+        bool                        overrun_ = false;
+        std::vector<unsigned char> &out_;
+    };
+
+    inline std::uint32_t be32(const unsigned char *p) {
+        return (std::uint32_t(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+
+    inline int paeth(int a, int b, int c) {
+        int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+        return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+    }
+}
+
+//------------------------------------------------------------------------------
+// PNG container: chunks → zlib stream → scanlines → RGBA8
+//------------------------------------------------------------------------------
+bool decodePng(const unsigned char *data, std::size_t size, PixelImage &out)
+{
+    static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (size < 8 || std::memcmp(data, signature, 8) != 0) return false;
+
+    std::uint32_t width = 0, height = 0;
+    int depth = 0, colorType = 0, interlace = 0;
+    std::vector<unsigned char> idat, palette, paletteAlpha, transparentKey;
+
+    for (std::size_t pos = 8; pos + 12 <= size;) {
+        std::uint32_t len = be32(data + pos);
+        const unsigned char *type = data + pos + 4, *body = data + pos + 8;
+        if (len > size - pos - 12) return false;
+
+        if (std::memcmp(type, "IHDR", 4) == 0 && len >= 13) {
+            width = be32(body); height = be32(body + 4);
+            depth = body[8]; colorType = body[9]; interlace = body[12];
+        }
+        else if (std::memcmp(type, "PLTE", 4) == 0) palette.assign(body, body + len);
+        else if (std::memcmp(type, "tRNS", 4) == 0) {
+            if (colorType == 3) paletteAlpha.assign(body, body + len);
+            else                transparentKey.assign(body, body + len);
+        }
+        else if (std::memcmp(type, "IDAT", 4) == 0) idat.insert(idat.end(), body, body + len);
+        else if (std::memcmp(type, "IEND", 4) == 0) break;
+        pos += std::size_t(len) + 12;
+    }
+
+    static const int channelsOf[7] = { 1, 0, 3, 1, 2, 0, 4 };
+    if (width == 0 || height == 0 || width > 16384 || height > 16384) return false;
+    if (depth != 8 || interlace != 0 || colorType > 6 || channelsOf[colorType] == 0) return false;
+    if (idat.size() < 2 || (idat[0] & 0x0F) != 8) return false;  // zlib, deflate
+
+    // ----------------------------------------------------------------------
+    // Inflate and undo the per-scanline filters
+    // ----------------------------------------------------------------------
+    const int         channels = channelsOf[colorType];
+    const std::size_t stride   = std::size_t(width) * channels;
+    std::vector<unsigned char> raw;
+    raw.reserve((stride + 1) * height);
+    if (!Inflater(idat.data() + 2, idat.size() - 2, raw).run() || raw.size() < (stride + 1) * height)
+        return false;
+
+    std::vector<unsigned char> pixels(stride * height);
+    for (std::uint32_t y = 0; y < height; y++) {
+        const unsigned char *src   = &raw[y * (stride + 1)];
+        unsigned char       *row   = &pixels[y * stride];
+        const unsigned char *above = y > 0 ? row - stride : nullptr;
+        int filter = *src++;
+
+        for (std::size_t i = 0; i < stride; i++) {
+            int a = i >= std::size_t(channels) ? row[i - channels] : 0;
+            int b = above ? above[i] : 0;
+            int c = (above && i >= std::size_t(channels)) ? above[i - channels] : 0;
+            int predicted;
+            switch (filter) {
+                case 0:  predicted = 0; break;
+                case 1:  predicted = a; break;
+                case 2:  predicted = b; break;
+                case 3:  predicted = (a + b) / 2; break;
+                case 4:  predicted = paeth(a, b, c); break;
+                default: return false;
+            }
+            row[i] = (unsigned char)(src[i] + predicted);
+        }
+    }
+
+    // ----------------------------------------------------------------------
+    // Expand to RGBA8
+    // ----------------------------------------------------------------------
+    out.width  = int(width);
+    out.height = int(height);
+    out.rgba.resize(std::size_t(width) * height * 4);
+
+    for (std::size_t i = 0, n = std::size_t(width) * height; i < n; i++) {
+        const unsigned char *p = &pixels[i * channels];
+        unsigned char       *o = &out.rgba[i * 4];
+        switch (colorType) {
+            case 0:  // gray
+                o[0] = o[1] = o[2] = p[0];
+                o[3] = (transparentKey.size() >= 2 && transparentKey[1] == p[0]) ? 0 : 255;
+                break;
+            case 2:  // RGB
+                o[0] = p[0]; o[1] = p[1]; o[2] = p[2];
+                o[3] = (transparentKey.size() >= 6 && transparentKey[1] == p[0]
+                        && transparentKey[3] == p[1] && transparentKey[5] == p[2]) ? 0 : 255;
+                break;
+            case 3:  // palette
+                if (std::size_t(p[0]) * 3 + 2 >= palette.size()) return false;
+                o[0] = palette[p[0] * 3]; o[1] = palette[p[0] * 3 + 1]; o[2] = palette[p[0] * 3 + 2];
+                o[3] = p[0] < paletteAlpha.size() ? paletteAlpha[p[0]] : 255;
+                break;
+            case 4:  // gray + alpha
+                o[0] = o[1] = o[2] = p[0];
+                o[3] = p[1];
+                break;
+            default: // RGBA
+                std::memcpy(o, p, 4);
+                break;
+        }
+    }
+    return true;
+}
+
+bool decodePngFile(const std::string &path, PixelImage &out)
+{
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    if (!ifs) return false;
+    std::vector<unsigned char> bytes(std::size_t(ifs.tellg()));
+    ifs.seekg(0);
+    if (!ifs.read(reinterpret_cast<char*>(bytes.data()), std::streamsize(bytes.size()))) return false;
+    return decodePng(bytes.data(), bytes.size(), out);
+}
@@ -0,0 +1,22 @@
+#ifndef _PNG_DECODER_H_
+#define _PNG_DECODER_H_
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "platform_handler.hpp"
+
+//------------------------------------------------------------------------------
+// Minimal PNG decoder for backends without raylib (SoftwarePlatform).
+// Handles what our sprite sheets use: 8-bit gray / gray+alpha / RGB / RGBA /
+// palette, non-interlaced, with tRNS transparency. Output is RGBA8.
+// Pure function of its input: safe on worker threads.
+//------------------------------------------------------------------------------
+bool decodePng(const unsigned char *data, std::size_t size, PixelImage &out);
+
+/// Read and decode a PNG file
+bool decodePngFile(const std::string &path, PixelImage &out);
+
+#endif
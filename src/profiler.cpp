@@ -0,0 +1,90 @@
+// profiler.cpp
+#include "profiler.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    //--------------------------------------------------------------------------
+    // Per-thread ring. Only its owner writes; `head` (total zones recorded) is
+    // published after each write so a dump can read up to it.
+    //--------------------------------------------------------------------------
+    struct ThreadRing {
+        std::array<ProfileEvent, ProfileRingSize> events;
+        std::atomic<std::uint64_t>                head{0};
+        std::atomic<const char*>                  name{nullptr};
+        unsigned int                              tid = 0;
+    };
+
+    const auto processStart = std::chrono::steady_clock::now();
+
+    // Rings outlive their threads so a dump still sees finished workers
+    std::mutex                               registryMutex;
+    std::vector<std::unique_ptr<ThreadRing>> registry;
+
+    ThreadRing& threadRing()
+    {
+        thread_local ThreadRing *ring = [] {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(std::make_unique<ThreadRing>());
+            registry.back()->tid = unsigned(registry.size());
+            return registry.back().get();
+        }();
+        return *ring;
+    }
+}
+
+std::uint64_t Profiler::now()
+{
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - processStart).count());
+}
+
+void Profiler::record(const char *name, std::uint64_t startNs, std::uint64_t endNs)
+{
+    ThreadRing &ring = threadRing();
+    std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+    ring.events[head % ProfileRingSize] = { name, startNs, endNs - startNs };
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char *name)
+{
+    threadRing().name.store(name, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+// Chrome trace format: one complete ("X") event per zone, times in µs
+//------------------------------------------------------------------------------
+bool Profiler::writeChromeTrace(const std::string &path)
+{
+    std::FILE *f = std::fopen(path.c_str(), "w");
+    if (f == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    std::size_t written = 0;
+    for (const auto &ring : registry) {
+        const char *threadName = ring->name.load(std::memory_order_relaxed);
+        std::fprintf(f, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,"
+                        "\"args\":{\"name\":\"%s\"}}",
+                     written++ ? ",\n" : "", ring->tid, threadName ? threadName : "thread");
+
+        std::uint64_t head  = ring->head.load(std::memory_order_acquire);
+        std::uint64_t first = head > ProfileRingSize ? head - ProfileRingSize : 0;
+        for (std::uint64_t i = first; i < head; i++) {
+            const ProfileEvent &e = ring->events[i % ProfileRingSize];
+            std::fprintf(f, ",\n{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%u,"
+                            "\"ts\":%.3f,\"dur\":%.3f}",
+                         e.name, ring->tid, e.startNs / 1000.0, e.durationNs / 1000.0);
+            written++;
+        }
+    }
+
+    std::fprintf(f, "\n]}\n");
+    return std::fclose(f) == 0;
+}
@@ -0,0 +1,78 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+//------------------------------------------------------------------------------
+// Scoped profiling zones, exported as a Chrome trace (chrome://tracing, Perfetto).
+//
+//     void PlayState::drawStage() {
+//         PROFILE_ZONE("PlayState::drawStage");
+//         ...
+//
+// Each zone records {name, start, duration} into a fixed ring buffer owned by
+// the calling thread (no locks, no allocation after the thread's first zone),
+// so the trace always holds the most recent ProfileRingSize zones per thread.
+// Zone names must be string literals.
+//
+// Only compiled in when KUNGFU_PROFILE is defined (cmake -DKUNGFU_PROFILE=ON);
+// otherwise the macros expand to nothing. The game writes PROFILE_TRACE_FILE
+// on F9 (DebugKey::DumpProfile) and at exit.
+//------------------------------------------------------------------------------
+#ifdef KUNGFU_PROFILE
+    constexpr bool ProfilingEnabled = true;
+    #define PROFILE_CONCAT_(a, b) a##b
+    #define PROFILE_CONCAT(a, b)  PROFILE_CONCAT_(a, b)
+    #define PROFILE_ZONE(name)    ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+    #define PROFILE_THREAD(name)  Profiler::setThreadName(name)
+#else
+    constexpr bool ProfilingEnabled = false;
+    #define PROFILE_ZONE(name)    ((void)0)
+    #define PROFILE_THREAD(name)  ((void)0)
+#endif
+
+constexpr std::size_t ProfileRingSize = 1 << 14;  ///< zones kept per thread (~10 s of play)
+
+/// One finished zone
+struct ProfileEvent {
+    const char    *name;
+    std::uint64_t  startNs;  ///< since process start
+    std::uint64_t  durationNs;
+};
+
+class Profiler {
+public:
+    /// Nanoseconds since process start (monotonic)
+    static std::uint64_t now();
+
+    /// Append a finished zone to the calling thread's ring
+    static void record(const char *name, std::uint64_t startNs, std::uint64_t endNs);
+
+    /// Label the calling thread in the trace ("main", "worker", ...)
+    static void setThreadName(const char *name);
+
+    /// Write every thread's ring as Chrome trace JSON. Meant to be called from
+    /// the main loop; zones a worker records meanwhile may be missing.
+    static bool writeChromeTrace(const std::string &path);
+};
+
+/// RAII zone: measures from construction to end of scope
+class ProfileZone {
+public:
+    explicit ProfileZone(const char *name) : name_(name), start_(Profiler::now()) {}
+    ~ProfileZone() { Profiler::record(name_, start_, Profiler::now()); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char    *name_;
+    std::uint64_t  start_;
+};
+
+#endif
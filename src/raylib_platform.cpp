@@ -0,0 +1,398 @@
+// raylib_platform.cpp
+#include "raylib_platform.hpp"
+#include "settings.hpp"
+
+#include <algorithm>
+#include <rlgl.h>
+
+//------------------------------------------------------------------------------
+// OpenGL entry points for frame readback. raylib does not expose pixel pack
+// buffers, and its GL headers are internal; windows.h and the X11 headers
+// clash with raylib.h, so the few functions needed are declared here.
+// glReadPixels is GL 1.1 (exported by opengl32 / libGL); the buffer calls
+// are GL 1.5 and looked up at runtime.
+//------------------------------------------------------------------------------
+#ifdef _WIN32
+#define GL_CALL __stdcall
+extern "C" __declspec(dllimport) void* __stdcall wglGetProcAddress(const char *name);
+#else
+#define GL_CALL
+extern "C" void (*glXGetProcAddressARB(const unsigned char *name))();
+#endif
+
+extern "C" void GL_CALL glReadPixels(int x, int y, int width, int height,
+                                     unsigned int format, unsigned int type, void *pixels);
+
+namespace {
+    constexpr unsigned int GL_RGBA_              = 0x1908;
+    constexpr unsigned int GL_UNSIGNED_BYTE_     = 0x1401;
+    constexpr unsigned int GL_PIXEL_PACK_BUFFER_ = 0x88EB;
+    constexpr unsigned int GL_STREAM_READ_       = 0x88E1;
+    constexpr unsigned int GL_READ_ONLY_         = 0x88B8;
+
+    struct PackBufferApi {
+        void  (GL_CALL *genBuffers)(int n, unsigned int *buffers)           = nullptr;
+        void  (GL_CALL *deleteBuffers)(int n, const unsigned int *buffers)  = nullptr;
+        void  (GL_CALL *bindBuffer)(unsigned int target, unsigned int buffer) = nullptr;
+        void  (GL_CALL *bufferData)(unsigned int target, std::ptrdiff_t size,
+                                    const void *data, unsigned int usage)   = nullptr;
+        void* (GL_CALL *mapBuffer)(unsigned int target, unsigned int access) = nullptr;
+        unsigned char (GL_CALL *unmapBuffer)(unsigned int target)           = nullptr;
+    };
+
+    template <typename Fn>
+    bool lookUp(Fn &fn, const char *name)
+    {
+#ifdef _WIN32
+        fn = reinterpret_cast<Fn>(wglGetProcAddress(name));
+#else
+        fn = reinterpret_cast<Fn>(glXGetProcAddressARB(reinterpret_cast<const unsigned char*>(name)));
+#endif
+        return fn != nullptr;
+    }
+
+    /// The buffer calls, or nullptr on GL 1.1 / ES contexts and broken drivers.
+    /// Needs a current context on first use.
+    const PackBufferApi* packBufferApi()
+    {
+        static const PackBufferApi *api = []() -> const PackBufferApi* {
+            const int version = rlGetVersion();
+            if (version != RL_OPENGL_21 && version != RL_OPENGL_33 && version != RL_OPENGL_43)
+                return nullptr;
+            static PackBufferApi loaded;
+            const bool ok = lookUp(loaded.genBuffers,    "glGenBuffers")
+                         && lookUp(loaded.deleteBuffers, "glDeleteBuffers")
+                         && lookUp(loaded.bindBuffer,    "glBindBuffer")
+                         && lookUp(loaded.bufferData,    "glBufferData")
+                         && lookUp(loaded.mapBuffer,     "glMapBuffer")
+                         && lookUp(loaded.unmapBuffer,   "glUnmapBuffer");
+            return ok ? &loaded : nullptr;
+        }();
+        return api;
+    }
+
+    constexpr std::ptrdiff_t FrameBytes = std::ptrdiff_t(GAME_WIDTH) * GAME_HEIGHT * 4;
+}
+
+//------------------------------------------------------------------------------
+// window & frame
+//------------------------------------------------------------------------------
+void RaylibPlatform::openWindow(int width, int height, const char *title)
+{
+    // Render at the monitor's refresh rate; gameplay ticks at TARGET_FPS
+    // independently (see FramePacer)
+    SetConfigFlags(FLAG_VSYNC_HINT);
+    InitWindow(width, height, title);
+    InitAudioDevice();
+    int refresh = GetMonitorRefreshRate(GetCurrentMonitor());
+    presentRate_ = refresh > 0 ? refresh : TARGET_FPS;
+    SetTargetFPS(presentRate_);
+    renderTexture_ = LoadRenderTexture(GAME_WIDTH, GAME_HEIGHT);
+}
+
+void RaylibPlatform::closeWindow()
+{
+    flushReadback();
+    if (packBuffers_[0] != 0) packBufferApi()->deleteBuffers(PackRing, packBuffers_);
+    if (presentTexture_.id != 0) UnloadTexture(presentTexture_);
+    UnloadRenderTexture(renderTexture_);
+    CloseAudioDevice();
+    CloseWindow();
+}
+
+void RaylibPlatform::beginFrame()
+{
+    BeginDrawing();
+    BeginTextureMode(renderTexture_);
+    ClearBackground(BLACK);
+}
+
+void RaylibPlatform::endFrame()
+{
+    EndTextureMode();
+    Rectangle src = {0, 0, float(GAME_WIDTH), float(-GAME_HEIGHT)};
+    Rectangle dst = {
+        (SCREEN_WIDTH/2.0f) - ((SCREEN_WIDTH * (float(GAME_HEIGHT)/GAME_WIDTH))/2.0f),
+        0, SCREEN_WIDTH * (float(GAME_HEIGHT)/GAME_WIDTH), SCREEN_HEIGHT
+    };
+
+    // The CPU present needs this frame now, so it reads back synchronously
+    // and the capture shares that copy. A capture alone goes through the
+    // pack buffers and never waits for the GPU.
+    if (cpuPresent_ || (capture_ != nullptr && !readFrameAsync()))
+    {
+        readFrame();
+        if (capture_ != nullptr) capture_->submit(readback_.data(), true);
+    }
+
+    if (cpuPresent_) presentUpscaled(dst);
+    else             DrawTexturePro(renderTexture_.texture, src, dst, {0,0}, 0, WHITE);
+    EndDrawing();
+}
+
+void RaylibPlatform::setCapture(FrameCapture *capture)
+{
+    flushReadback();
+    capture_ = capture;
+
+    // Pack buffers are only worth their GPU memory while capturing
+    const PackBufferApi *gl = packBufferApi();
+    if (capture_ == nullptr || gl == nullptr || packBuffers_[0] != 0) return;
+    gl->genBuffers(PackRing, packBuffers_);
+    for (unsigned int buffer : packBuffers_) {
+        gl->bindBuffer(GL_PIXEL_PACK_BUFFER_, buffer);
+        gl->bufferData(GL_PIXEL_PACK_BUFFER_, FrameBytes, nullptr, GL_STREAM_READ_);
+    }
+    gl->bindBuffer(GL_PIXEL_PACK_BUFFER_, 0);
+}
+
+// RGBA8 comes back bottom-up; on little-endian hosts each pixel is the
+// r | g << 8 | b << 16 | a << 24 word FrameCapture and Upscaler expect.
+void RaylibPlatform::readFrame()
+{
+    if (readback_.empty()) readback_.resize(std::size_t(GAME_WIDTH) * GAME_HEIGHT);
+    rlEnableFramebuffer(renderTexture_.id);
+    glReadPixels(0, 0, GAME_WIDTH, GAME_HEIGHT, GL_RGBA_, GL_UNSIGNED_BYTE_, readback_.data());
+    rlDisableFramebuffer();
+}
+
+bool RaylibPlatform::readFrameAsync()
+{
+    if (packBuffers_[0] == 0) return false;
+    // The oldest copy was issued PackRing frames ago, so mapping it no longer stalls
+    if (packsStarted_ - packsSubmitted_ == PackRing) submitPacked(packsSubmitted_++);
+
+    const PackBufferApi *gl = packBufferApi();
+    rlEnableFramebuffer(renderTexture_.id);
+    gl->bindBuffer(GL_PIXEL_PACK_BUFFER_, packBuffers_[packsStarted_ % PackRing]);
+    glReadPixels(0, 0, GAME_WIDTH, GAME_HEIGHT, GL_RGBA_, GL_UNSIGNED_BYTE_, nullptr);  // offset 0
+    gl->bindBuffer(GL_PIXEL_PACK_BUFFER_, 0);
+    rlDisableFramebuffer();
+    packsStarted_++;
+    return true;
+}
+
+void RaylibPlatform::flushReadback()
+{
+    while (packsSubmitted_ < packsStarted_) submitPacked(packsSubmitted_++);
+}
+
+void RaylibPlatform::submitPacked(std::uint64_t copy)
+{
+    const PackBufferApi *gl = packBufferApi();
+    gl->bindBuffer(GL_PIXEL_PACK_BUFFER_, packBuffers_[copy % PackRing]);
+    if (const void *pixels = gl->mapBuffer(GL_PIXEL_PACK_BUFFER_, GL_READ_ONLY_)) {
+        if (capture_ != nullptr) capture_->submit(static_cast<const std::uint32_t*>(pixels), true);
+        gl->unmapBuffer(GL_PIXEL_PACK_BUFFER_);
+    }
+    gl->bindBuffer(GL_PIXEL_PACK_BUFFER_, 0);
+}
+
+void RaylibPlatform::setPresentFilter(UpscaleFilter filter, int nearestFactor)
+{
+    upscaler_.setFilter(filter, nearestFactor);
+    cpuPresent_ = true;
+}
+
+void RaylibPlatform::presentUpscaled(Rectangle dst)
+{
+    // readback_ is bottom-up (and already submitted), turn it over in place
+    for (int top = 0, bottom = GAME_HEIGHT - 1; top < bottom; top++, bottom--)
+        std::swap_ranges(readback_.begin() + std::ptrdiff_t(top) * GAME_WIDTH,
+                         readback_.begin() + std::ptrdiff_t(top + 1) * GAME_WIDTH,
+                         readback_.begin() + std::ptrdiff_t(bottom) * GAME_WIDTH);
+    upscaler_.run(readback_.data(), GAME_WIDTH, GAME_HEIGHT);
+
+    const int w = upscaler_.outputWidth(), h = upscaler_.outputHeight();
+    if (presentTexture_.width != w || presentTexture_.height != h) {
+        if (presentTexture_.id != 0) UnloadTexture(presentTexture_);
+        Image img = { const_cast<std::uint32_t*>(upscaler_.output()), w, h, 1,
+                      PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        presentTexture_ = LoadTextureFromImage(img);
+        SetTextureFilter(presentTexture_, TEXTURE_FILTER_POINT);
+    }
+    else {
+        UpdateTexture(presentTexture_, upscaler_.output());
+    }
+    DrawTexturePro(presentTexture_, { 0, 0, float(w), float(h) }, dst, {0,0}, 0, WHITE);
+}
+
+int RaylibPlatform::toRaylibKey(Key key)
+{
+    switch (key) {
+        case Key::Left:   return KEY_LEFT;
+        case Key::Right:  return KEY_RIGHT;
+        case Key::Up:     return KEY_UP;
+        case Key::Down:   return KEY_DOWN;
+        case Key::A:      return KEY_A;
+        case Key::S:      return KEY_S;
+        case Key::Enter:  return KEY_ENTER;
+        case Key::Escape: return KEY_ESCAPE;
+        default:          return 0;
+    }
+}
+
+bool RaylibPlatform::isDebugKeyPressed(DebugKey key)
+{
+    switch (key) {
+        case DebugKey::DumpProfile: return IsKeyPressed(KEY_F9);
+        case DebugKey::Rewind:      return IsKeyPressed(KEY_BACKSPACE);
+        default:                    return false;
+    }
+}
+
+bool RaylibPlatform::isDebugKeyDown(DebugKey key)
+{
+    switch (key) {
+        case DebugKey::DumpProfile: return IsKeyDown(KEY_F9);
+        case DebugKey::Rewind:      return IsKeyDown(KEY_BACKSPACE);
+        default:                    return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+// decoding (LoadImage/LoadWave only touch the file and CPU memory, so these
+// run fine on worker threads)
+//------------------------------------------------------------------------------
+bool RaylibPlatform::decodeImage(const std::string &path, PixelImage &out)
+{
+    Image img = LoadImage(path.c_str());
+    if (img.data == nullptr) return false;
+    ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    const auto *pixels = static_cast<const unsigned char*>(img.data);
+    out.width  = img.width;
+    out.height = img.height;
+    out.rgba.assign(pixels, pixels + size_t(img.width) * img.height * 4);
+    UnloadImage(img);
+    return true;
+}
+
+bool RaylibPlatform::decodeWave(const std::string &path, PcmWave &out)
+{
+    Wave wave = LoadWave(path.c_str());
+    if (wave.data == nullptr) return false;
+
+    const auto *samples = static_cast<const unsigned char*>(wave.data);
+    out.frameCount = wave.frameCount;
+    out.sampleRate = wave.sampleRate;
+    out.sampleSize = wave.sampleSize;
+    out.channels   = wave.channels;
+    out.samples.assign(samples, samples + size_t(wave.frameCount) * wave.channels * (wave.sampleSize / 8));
+    UnloadWave(wave);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// textures & drawing
+//------------------------------------------------------------------------------
+TextureHandle RaylibPlatform::loadTexture(const std::string &path)
+{
+    Texture2D tex = LoadTexture(path.c_str());
+    return { tex.id, tex.width, tex.height };
+}
+
+TextureHandle RaylibPlatform::loadTextureFromPixels(int width, int height, const void *rgba)
+{
+    // raylib only reads the pixels during upload, so the mapping can be used as-is
+    Image img = { const_cast<void*>(rgba), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    Texture2D tex = LoadTextureFromImage(img);
+    return { tex.id, tex.width, tex.height };
+}
+
+void RaylibPlatform::unloadTexture(TextureHandle &texture)
+{
+    if (RenderTexture2D *target = findRenderTarget(texture.id)) {
+        UnloadRenderTexture(*target);
+        renderTargets_.erase(renderTargets_.begin() + (target - renderTargets_.data()));
+    }
+    else if (texture.id != 0) {
+        UnloadTexture(toTexture(texture));
+    }
+    texture = {};
+}
+
+TextureHandle RaylibPlatform::createRenderTarget(int width, int height)
+{
+    RenderTexture2D target = LoadRenderTexture(width, height);
+    if (target.id == 0) return {};
+    renderTargets_.push_back(target);
+    return { target.texture.id, width, height };
+}
+
+void RaylibPlatform::beginRenderTarget(const TextureHandle &target)
+{
+    if (RenderTexture2D *rt = findRenderTarget(target.id)) {
+        BeginTextureMode(*rt);
+        ClearBackground(BLANK);
+    }
+}
+
+RenderTexture2D* RaylibPlatform::findRenderTarget(unsigned int id)
+{
+    for (auto &target : renderTargets_)
+        if (id != 0 && target.texture.id == id) return &target;
+    return nullptr;
+}
+
+void RaylibPlatform::drawTexture(const TextureHandle &texture, const Rect &src,
+                                 float x, float y, DrawLayer)
+{
+    Rectangle rect = { src.x, src.y, src.width, src.height };
+    if (findRenderTarget(texture.id) != nullptr) {
+        // render targets are stored bottom-up
+        rect.y      = texture.height - src.y - src.height;
+        rect.height = -src.height;
+    }
+    // rlgl batches consecutive quads of one texture, so FramePacer's
+    // texture-sorted order becomes one batch per texture run
+    DrawTextureRec(toTexture(texture), rect, { x, y }, WHITE);
+}
+
+//------------------------------------------------------------------------------
+// audio
+//------------------------------------------------------------------------------
+SoundHandle RaylibPlatform::loadSound(const std::string &path)
+{
+    sounds_.push_back(LoadSound(path.c_str()));
+    return { int(sounds_.size()) - 1 };
+}
+
+SoundHandle RaylibPlatform::loadSoundFromPcm(unsigned int frameCount, unsigned int sampleRate,
+                                             unsigned int sampleSize, unsigned int channels,
+                                             const void *samples)
+{
+    Wave wave = { frameCount, sampleRate, sampleSize, channels, const_cast<void*>(samples) };
+    sounds_.push_back(LoadSoundFromWave(wave)); // copies into the audio buffer
+    return { int(sounds_.size()) - 1 };
+}
+
+Sound* RaylibPlatform::findSound(SoundHandle sound)
+{
+    return sound.id >= 0 && std::size_t(sound.id) < sounds_.size() ? &sounds_[std::size_t(sound.id)] : nullptr;
+}
+
+void RaylibPlatform::unloadSound(SoundHandle sound) { if (Sound *s = findSound(sound)) UnloadSound(*s); }
+void RaylibPlatform::playSound(SoundHandle sound)   { if (Sound *s = findSound(sound)) PlaySound(*s); }
+
+MusicHandle RaylibPlatform::loadMusic(const std::string &path)
+{
+    musics_.push_back(LoadMusicStream(path.c_str()));
+    return { int(musics_.size()) - 1 };
+}
+
+MusicHandle RaylibPlatform::loadMusicFromMemory(const char *fileType, const void *data, int size)
+{
+    musics_.push_back(LoadMusicStreamFromMemory(fileType, static_cast<const unsigned char*>(data), size));
+    return { int(musics_.size()) - 1 };
+}
+
+Music* RaylibPlatform::findMusic(MusicHandle music)
+{
+    return music.id >= 0 && std::size_t(music.id) < musics_.size() ? &musics_[std::size_t(music.id)] : nullptr;
+}
+
+void RaylibPlatform::unloadMusic(MusicHandle music) { if (Music *m = findMusic(music)) UnloadMusicStream(*m); }
+void RaylibPlatform::playMusic(MusicHandle music)   { if (Music *m = findMusic(music)) PlayMusicStream(*m); }
+void RaylibPlatform::updateMusic(MusicHandle music) { if (Music *m = findMusic(music)) UpdateMusicStream(*m); }
+void RaylibPlatform::stopMusic(MusicHandle music)   { if (Music *m = findMusic(music)) StopMusicStream(*m); }
@@ -0,0 +1,119 @@
+#ifndef _RAYLIB_PLATFORM_H_
+#define _RAYLIB_PLATFORM_H_
+
+#pragma once
+
+#include <raylib.h>
+#include <cstdint>
+#include <vector>
+
+#include "platform_handler.hpp"
+#include "upscaler.hpp"
+#include "frame_capture.hpp"
+
+//------------------------------------------------------------------------------
+// RaylibPlatform: the windowed backend (OpenGL, keyboard, audio device).
+// Everything is drawn into a GAME_WIDTH x GAME_HEIGHT render texture which
+// endFrame() scales to the window: on the GPU with the driver's filter, or
+// through a CPU Upscaler once setPresentFilter() was called.
+//------------------------------------------------------------------------------
+class RaylibPlatform : public Platform {
+public:
+    void openWindow(int width, int height, const char *title) override;
+    void closeWindow() override;
+    bool shouldClose() override { return WindowShouldClose(); }
+    double now() override       { return GetTime(); }
+
+    void beginFrame() override;
+    void endFrame() override;
+
+    /// Upscale each frame on the CPU with `filter` before it is stretched to
+    /// the window with point sampling (costs a GPU readback per frame)
+    void setPresentFilter(UpscaleFilter filter, int nearestFactor);
+
+    /// Queue every native frame into `capture` (nullptr = stop). Only the
+    /// readback happens on the render thread; encoding and I/O do not. The
+    /// readback is asynchronous where the driver has pixel buffers, so frames
+    /// reach `capture` a few frames late; the ones still in flight are handed
+    /// over when the capture changes and in closeWindow().
+    void setCapture(FrameCapture *capture);
+    /// Frames presented per second (the monitor's refresh), after openWindow
+    int presentRate() const { return presentRate_; }
+
+    bool isKeyDown(Key key) override     { return IsKeyDown(toRaylibKey(key)); }
+    bool isKeyReleased(Key key) override { return IsKeyReleased(toRaylibKey(key)); }
+    bool isDebugKeyPressed(DebugKey key) override;
+    bool isDebugKeyDown(DebugKey key) override;
+
+    bool decodeImage(const std::string &path, PixelImage &out) override;
+    bool decodeWave(const std::string &path, PcmWave &out) override;
+
+    TextureHandle loadTexture(const std::string &path) override;
+    TextureHandle loadTextureFromPixels(int width, int height, const void *rgba) override;
+    void unloadTexture(TextureHandle &texture) override;
+    TextureHandle createRenderTarget(int width, int height) override;
+    void beginRenderTarget(const TextureHandle &target) override;
+    void endRenderTarget() override { EndTextureMode(); }
+    void drawTexture(const TextureHandle &texture, const Rect &src,
+                     float x, float y, DrawLayer layer) override;
+
+    SoundHandle loadSound(const std::string &path) override;
+    SoundHandle loadSoundFromPcm(unsigned int frameCount, unsigned int sampleRate,
+                                 unsigned int sampleSize, unsigned int channels,
+                                 const void *samples) override;
+    void unloadSound(SoundHandle sound) override;
+    void playSound(SoundHandle sound) override;
+
+    MusicHandle loadMusic(const std::string &path) override;
+    MusicHandle loadMusicFromMemory(const char *fileType, const void *data, int size) override;
+    void unloadMusic(MusicHandle music) override;
+    void playMusic(MusicHandle music) override;
+    void updateMusic(MusicHandle music) override;
+    void stopMusic(MusicHandle music) override;
+
+private:
+    static int toRaylibKey(Key key);
+
+    /// Rebuild the raylib texture struct from our handle
+    static inline Texture2D toTexture(const TextureHandle &t) {
+        return { t.id, t.width, t.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    }
+
+    /// Render target whose color texture is `id`, or nullptr
+    RenderTexture2D* findRenderTarget(unsigned int id);
+
+    /// The loaded sound / music behind a handle, or nullptr (id -1: its load failed)
+    Sound* findSound(SoundHandle sound);
+    Music* findMusic(MusicHandle music);
+
+    /// endFrame with setPresentFilter: upscale readback_, upload, draw
+    void presentUpscaled(Rectangle dst);
+
+    /// Copy the finished frame into readback_ (bottom-up), waiting for the GPU
+    void readFrame();
+    /// Start copying the finished frame into a pack buffer and submit the
+    /// oldest copy to capture_ once the ring is full. False without buffers.
+    bool readFrameAsync();
+    /// Submit every copy still in flight to capture_, oldest first
+    void flushReadback();
+    /// Map the pack buffer of copy number `copy`, submit it, unmap
+    void submitPacked(std::uint64_t copy);
+
+    static constexpr int PackRing = 3;  ///< async copies in flight
+
+    RenderTexture2D     renderTexture_{};  ///< offscreen GAME_WIDTH x GAME_HEIGHT target
+    std::vector<RenderTexture2D> renderTargets_;  ///< createRenderTarget() results
+    bool                cpuPresent_ = false;  ///< setPresentFilter() was called
+    Upscaler            upscaler_;
+    Texture2D           presentTexture_{};     ///< upscaler_ output, point-sampled
+    FrameCapture       *capture_ = nullptr;
+    std::vector<std::uint32_t> readback_;  ///< readFrame() target, reused
+    unsigned int        packBuffers_[PackRing] = {};  ///< GL pixel pack buffers, 0 = none
+    std::uint64_t       packsStarted_   = 0;  ///< async copies issued
+    std::uint64_t       packsSubmitted_ = 0;  ///< of those, handed to capture_
+    int                 presentRate_ = TARGET_FPS;
+    std::vector<Sound>  sounds_;
+    std::vector<Music>  musics_;
+};
+
+#endif
@@ -0,0 +1,175 @@
+// replay_handler.cpp
+#include "replay_handler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+//------------------------------------------------------------------------------
+// recording
+//------------------------------------------------------------------------------
+void Replay::begin(const ReplayStart &start, std::uint32_t keyframeInterval)
+{
+    file_.close();
+    keys_      = nullptr;
+    snapshots_ = nullptr;
+    keyCount_  = 0;
+
+    start_    = start;
+    interval_ = keyframeInterval;
+    runs_.clear();
+    recordedKeys_.clear();
+    recordedSnapshots_.clear();
+    ticks_ = 0;
+    rewind();
+}
+
+void Replay::addKeyframe(const SimSnapshot &state)
+{
+    // Cursor at the end of the last run: next() steps to the following one
+    const std::uint32_t run   = runs_.empty() ? 0 : std::uint32_t(runs_.size() - 1);
+    const std::uint32_t inRun = runs_.empty() ? 0 : runs_.back().count;
+    recordedKeys_.push_back({ ticks_, run, inRun, 0 });
+    recordedSnapshots_.push_back(state);
+}
+
+void Replay::record(InputSnapshot input)
+{
+    if (!runs_.empty() && runs_.back().bits == input.bits && runs_.back().count != UINT16_MAX)
+        runs_.back().count++;
+    else
+        runs_.push_back({ input.bits, 1 });
+    ticks_++;
+}
+
+bool Replay::save(const std::string &path) const
+{
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs) return false;
+
+    const std::size_t indexEnd = sizeof(ReplayHeader) + sizeof(ReplayIndexHeader)
+                               + runs_.size() * sizeof(ReplayRun)
+                               + recordedKeys_.size() * sizeof(ReplayKeyframe);
+    const std::size_t snapshotOffset = (indexEnd + ReplaySnapshotAlignment - 1)
+                                     / ReplaySnapshotAlignment * ReplaySnapshotAlignment;
+
+    ReplayHeader      header = { ReplayMagic, ReplayVersion, start_, ticks_, std::uint32_t(runs_.size()) };
+    ReplayIndexHeader index  = { interval_, std::uint32_t(recordedKeys_.size()), SnapshotVersion,
+                                 std::uint32_t(sizeof(SimSnapshot)), std::uint32_t(snapshotOffset), {} };
+    const char padding[ReplaySnapshotAlignment] = {};
+
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(&index), sizeof(index));
+    ofs.write(reinterpret_cast<const char*>(runs_.data()), std::streamsize(runs_.size() * sizeof(ReplayRun)));
+    ofs.write(reinterpret_cast<const char*>(recordedKeys_.data()),
+              std::streamsize(recordedKeys_.size() * sizeof(ReplayKeyframe)));
+    ofs.write(padding, std::streamsize(snapshotOffset - indexEnd));
+    ofs.write(reinterpret_cast<const char*>(recordedSnapshots_.data()),
+              std::streamsize(recordedSnapshots_.size() * sizeof(SimSnapshot)));
+    return bool(ofs);
+}
+
+//------------------------------------------------------------------------------
+// playback
+//------------------------------------------------------------------------------
+bool Replay::load(const std::string &path)
+{
+    MappedFile file;
+    if (!file.open(path)) return false;
+    const std::uint8_t *base = file.data();
+    const std::size_t   size = file.size();
+
+    ReplayHeader header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, base, sizeof(header));
+    if (header.magic != ReplayMagic || (header.version != 1 && header.version != ReplayVersion))
+        return false;
+
+    // The start is used as is (it picks the enemy tables), so it has to be one the game can be in
+    const ReplayStart &start = header.start;
+    if (start.state < int(GameState::Intro) || start.state > int(GameState::Play)
+        || start.level < 1 || start.level > std::int32_t(EnemyCount))
+        return false;
+
+    ReplayIndexHeader index{};
+    std::size_t at = sizeof(header);
+    if (header.version >= 2)
+    {
+        if (size < at + sizeof(index)) return false;
+        std::memcpy(&index, base + at, sizeof(index));
+        at += sizeof(index);
+    }
+
+    // Runs, and the tick each one starts at (to check the keyframes against)
+    if (size - at < std::size_t(header.runCount) * sizeof(ReplayRun)) return false;
+    std::vector<ReplayRun> runs(header.runCount);
+    std::memcpy(runs.data(), base + at, runs.size() * sizeof(ReplayRun));
+    at += runs.size() * sizeof(ReplayRun);
+
+    std::vector<std::uint32_t> runStart(runs.size() + 1, 0);
+    for (std::size_t r = 0; r < runs.size(); r++) runStart[r + 1] = runStart[r] + runs[r].count;
+    if (runStart.back() != header.tickCount) return false;
+
+    // Keyframe index: in tick order, cursors consistent with the runs
+    if (size - at < std::size_t(index.keyframeCount) * sizeof(ReplayKeyframe)) return false;
+    const auto *keys = reinterpret_cast<const ReplayKeyframe*>(base + at);
+    for (std::uint32_t k = 0; k < index.keyframeCount; k++)
+    {
+        const ReplayKeyframe &key = keys[k];
+        if (key.tick > header.tickCount || (k > 0 && key.tick <= keys[k - 1].tick)
+            || (runs.empty() ? key.run != 0 || key.inRun != 0
+                             : key.run >= runs.size() || key.inRun > runs[key.run].count
+                               || runStart[key.run] + key.inRun != key.tick))
+            return false;
+    }
+
+    // Keyframes of another snapshot layout cannot be restored: play from the start only
+    const bool usable = index.keyframeCount > 0
+                     && index.snapshotVersion == SnapshotVersion
+                     && index.snapshotSize == sizeof(SimSnapshot)
+                     && index.snapshotOffset % alignof(SimSnapshot) == 0
+                     && index.snapshotOffset <= size
+                     && (size - index.snapshotOffset) / sizeof(SimSnapshot) >= index.keyframeCount;
+
+    file_      = std::move(file);
+    keys_      = usable ? keys : nullptr;
+    snapshots_ = usable ? file_.data() + index.snapshotOffset : nullptr;
+    keyCount_  = usable ? index.keyframeCount : 0;
+    interval_  = index.keyframeInterval;
+    recordedKeys_.clear();
+    recordedSnapshots_.clear();
+
+    start_ = header.start;
+    runs_  = std::move(runs);
+    ticks_ = header.tickCount;
+    rewind();
+    return true;
+}
+
+bool Replay::next(InputSnapshot &input)
+{
+    while (run_ < runs_.size() && inRun_ >= runs_[run_].count) {
+        run_++;
+        inRun_ = 0;
+    }
+    if (run_ >= runs_.size()) return false;
+
+    input.bits = runs_[run_].bits;
+    inRun_++;
+    tick_++;
+    return true;
+}
+
+const SimSnapshot* Replay::seekKeyframe(std::uint32_t tick)
+{
+    const ReplayKeyframe *end   = keys_ + keyCount_;
+    const ReplayKeyframe *after = std::upper_bound(keys_, end, tick,
+        [](std::uint32_t t, const ReplayKeyframe &key) { return t < key.tick; });
+    if (after == keys_) return nullptr;
+
+    const ReplayKeyframe &key = after[-1];
+    run_   = key.run;
+    inRun_ = std::uint16_t(key.inRun);
+    tick_  = key.tick;
+    return reinterpret_cast<const SimSnapshot*>(snapshots_ + std::size_t(after - 1 - keys_) * sizeof(SimSnapshot));
+}
@@ -0,0 +1,136 @@
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "platform_handler.hpp"
+#include "settings.hpp"
+#include "sim_snapshot.hpp"
+
+//------------------------------------------------------------------------------
+// Replay: RNG seed + starting state + one InputSnapshot per tick.
+//
+// The simulation only depends on these (fixed timestep, Game-owned seeded
+// RNG), so feeding the inputs back reproduces a session bit-for-bit. Inputs
+// are stored run-length encoded: keys change a few times per second, so an
+// hour of play stays in the tens of KB.
+//
+// Every `keyframeInterval` ticks a recording also keeps the whole simulation
+// (SimSnapshot), so playback can start anywhere: restore the keyframe at or
+// before the tick, then simulate the ticks after it. A seek never simulates
+// more than keyframeInterval - 1 ticks. Files are mapped (MappedFile) and
+// keyframes are restored straight from the mapping.
+//
+// File layout (little-endian):
+//   ReplayHeader
+//   ReplayIndexHeader                    version 2 only
+//   ReplayRun[header.runCount]
+//   ReplayKeyframe[index.keyframeCount]  version 2 only
+//   SimSnapshot[index.keyframeCount]     version 2, at index.snapshotOffset
+//
+// Version 1 files (no index) still play, from the start only. Keyframes from
+// a build with another SimSnapshot layout are ignored the same way.
+//------------------------------------------------------------------------------
+constexpr std::uint32_t ReplayMagic             = 0x5052464B;  ///< "KFRP"
+constexpr std::uint32_t ReplayVersion           = 2;
+constexpr std::uint32_t ReplaySnapshotAlignment = 64;
+
+/// What the simulation looked like before the first recorded tick
+struct ReplayStart {
+    std::uint32_t seed  = 0;
+    std::int32_t  state = 0;   ///< GameState
+    std::int32_t  level = 1;
+    std::int32_t  score = 0;
+};
+
+struct ReplayHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    ReplayStart   start;
+    std::uint32_t tickCount;
+    std::uint32_t runCount;
+};
+
+struct ReplayIndexHeader {
+    std::uint32_t keyframeInterval;  ///< ticks between keyframes
+    std::uint32_t keyframeCount;
+    std::uint32_t snapshotVersion;   ///< SnapshotVersion of the recording build
+    std::uint32_t snapshotSize;      ///< sizeof(SimSnapshot) there
+    std::uint32_t snapshotOffset;    ///< of the first keyframe's SimSnapshot, from the start of the file
+    std::uint32_t reserved[3];
+};
+
+struct ReplayRun {
+    std::uint16_t bits;    ///< InputSnapshot::bits
+    std::uint16_t count;   ///< consecutive ticks with that input
+};
+
+/// Where keyframe i starts playing: SimSnapshot i is the state before `tick`
+struct ReplayKeyframe {
+    std::uint32_t tick;
+    std::uint32_t run;     ///< playback cursor at that tick
+    std::uint32_t inRun;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(ReplayHeader)      == 32, "replay header layout");
+static_assert(sizeof(ReplayIndexHeader) == 32, "replay index header layout");
+static_assert(sizeof(ReplayRun)         == 4,  "replay run layout");
+static_assert(sizeof(ReplayKeyframe)    == 16, "replay keyframe layout");
+static_assert(alignof(SimSnapshot) <= ReplaySnapshotAlignment, "keyframes are used in place");
+
+class Replay {
+public:
+    // ----------------------------------------------------------------
+    // recording
+    void begin(const ReplayStart &start, std::uint32_t keyframeInterval = REPLAY_KEYFRAME_INTERVAL);
+    /// True when the next tick should be preceded by addKeyframe()
+    inline bool keyframeDue() const { return interval_ > 0 && ticks_ % interval_ == 0; }
+    /// The simulation before the next recorded tick
+    void addKeyframe(const SimSnapshot &state);
+    void record(InputSnapshot input);
+    bool save(const std::string &path) const;
+
+    // ----------------------------------------------------------------
+    // playback
+    /// False (nothing changed) if the file is unreadable, malformed or starts
+    /// in a state or level the game does not have
+    bool load(const std::string &path);
+    /// Input of the next tick; false once every recorded tick was played
+    bool next(InputSnapshot &input);
+    void rewind() { run_ = 0; inRun_ = 0; tick_ = 0; }
+
+    /// Move the cursor to the last keyframe at or before `tick` and return
+    /// its state (nullptr, cursor unchanged, if there is none)
+    const SimSnapshot* seekKeyframe(std::uint32_t tick);
+
+    inline const ReplayStart& start() const            { return start_; }
+    inline std::uint32_t      tickCount() const        { return ticks_; }
+    inline std::size_t        runCount() const         { return runs_.size(); }
+    inline std::uint32_t      position() const         { return tick_; }  ///< ticks played
+    inline std::uint32_t      keyframeCount() const    { return keyCount_; }
+    inline std::uint32_t      keyframeInterval() const { return interval_; }
+
+private:
+    ReplayStart            start_;
+    std::vector<ReplayRun> runs_;
+    std::uint32_t          ticks_    = 0;
+    std::size_t            run_      = 0;  ///< playback cursor
+    std::uint16_t          inRun_    = 0;
+    std::uint32_t          tick_     = 0;
+    std::uint32_t          interval_ = 0;  ///< ticks between keyframes (0: none)
+
+    std::vector<ReplayKeyframe> recordedKeys_;       ///< while recording
+    std::vector<SimSnapshot>    recordedSnapshots_;
+    MappedFile                  file_;               ///< while playing
+    const ReplayKeyframe       *keys_      = nullptr;
+    const std::uint8_t         *snapshots_ = nullptr;
+    std::uint32_t               keyCount_  = 0;
+};
+
+#endif
@@ -0,0 +1,113 @@
+// residency_handler.cpp
+#include "residency_handler.hpp"
+#include "game_handler.hpp"
+
+#include <chrono>
+
+void EnemyResidency::addTexture(std::size_t enemy, Texture texture)
+{
+    textures_[enemy].push_back(std::move(texture));
+}
+
+void EnemyResidency::enterLevel(int level)
+{
+    const std::size_t current = std::size_t(level - 1);
+    const std::size_t next    = current + 1;
+
+    for (std::size_t e = 0; e < EnemyCount; e++) {
+        if (e != current && e != next) evict(e);
+    }
+
+    if (current < EnemyCount) {
+        wanted_[current] = true;
+        for (auto &tex : textures_[current]) {
+            if (tex.texture.id == 0) upload(tex); // blocks only if never prefetched
+        }
+    }
+    if (next < EnemyCount) prefetch(next);
+}
+
+void EnemyResidency::update()
+{
+    for (std::size_t e = 0; e < EnemyCount; e++) {
+        if (!wanted_[e]) continue;
+        for (auto &tex : textures_[e]) {
+            if (tex.texture.id != 0) continue;
+            bool ready = tex.archived
+                      || (tex.decoding.valid()
+                          && tex.decoding.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+            if (ready) upload(tex);
+        }
+    }
+}
+
+bool EnemyResidency::isResident(std::size_t enemy) const
+{
+    for (const auto &tex : textures_[enemy]) {
+        if (tex.texture.id == 0) return false;
+    }
+    return true;
+}
+
+void EnemyResidency::unloadAll()
+{
+    for (std::size_t e = 0; e < EnemyCount; e++) evict(e);
+}
+
+//------------------------------------------------------------------------------
+// internals
+//------------------------------------------------------------------------------
+void EnemyResidency::prefetch(std::size_t enemy)
+{
+    wanted_[enemy] = true;
+    for (auto &tex : textures_[enemy]) {
+        // archive images are already decoded: update() uploads them directly
+        if (tex.texture.id != 0 || tex.archived || tex.decoding.valid()) continue;
+        startDecode(tex);
+    }
+}
+
+void EnemyResidency::startDecode(Texture &tex)
+{
+    tex.decoding = game_.workers.submit([&platform = game_.platform, path = tex.source] {
+        PixelImage img;
+        if (!platform.decodeImage(path, img)) img = {};
+        return img;
+    });
+}
+
+void EnemyResidency::upload(Texture &tex)
+{
+    TextureHandle handle;
+    if (tex.archived) {
+        handle = game_.archiveTexture(tex.source);
+    }
+    else {
+        if (!tex.decoding.valid()) startDecode(tex);
+        PixelImage img = tex.decoding.get();
+        if (img.width > 0)
+            handle = game_.platform.loadTextureFromPixels(img.width, img.height, img.rgba.data());
+    }
+    tex.texture = handle;
+    attach(tex, handle);
+}
+
+void EnemyResidency::evict(std::size_t enemy)
+{
+    wanted_[enemy] = false;
+    for (auto &tex : textures_[enemy]) {
+        if (tex.texture.id == 0) continue;
+        TextureHandle gone = { 0, tex.texture.width, tex.texture.height };  // keep the size
+        game_.platform.unloadTexture(tex.texture);
+        attach(tex, gone);
+    }
+}
+
+void EnemyResidency::attach(const Texture &tex, const TextureHandle &handle)
+{
+    for (const auto &[id, region] : tex.users) {
+        game_.sprite(id).setTexture(handle, tex.wholeImage
+            ? Rect{ 0, 0, float(handle.width), float(handle.height) }
+            : region);
+    }
+}
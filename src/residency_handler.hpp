@@ -0,0 +1,69 @@
+#ifndef _RESIDENCY_H_
+#define _RESIDENCY_H_
+
+#pragma once
+
+#include <array>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "asset_ids.hpp"
+#include "platform_handler.hpp"
+
+class Game;
+
+//------------------------------------------------------------------------------
+// EnemyResidency: keeps only the current and the next level's enemy textures
+// loaded.
+//
+// Game hands over every texture used by a single enemy only (its five loose
+// sheets, or an atlas page holding nothing else). Entering a level (in
+// PreviewState) evicts every other enemy, makes the current one resident
+// and queues the next one's decode on Game::workers; update() uploads the
+// results on the main thread as they finish, so the level transition never
+// has to load anything.
+//------------------------------------------------------------------------------
+class EnemyResidency {
+public:
+    /// One texture owned by a single enemy
+    struct Texture {
+        std::string source;              ///< image file, or archive entry when `archived`
+        bool        archived   = false;
+        bool        wholeImage = true;   ///< sprites cover the whole image (no atlas)
+        std::vector<std::pair<SpriteId, Rect>> users;  ///< sprites drawing from it (+ atlas region)
+
+        TextureHandle           texture;   ///< id 0 while evicted
+        std::future<PixelImage> decoding;  ///< prefetch in flight (width 0 = failed)
+    };
+
+    explicit EnemyResidency(Game &game) : game_(game) {}
+
+    void addTexture(std::size_t enemy, Texture texture);
+
+    /// Level `level` starts: load its enemy now if the prefetch has not
+    /// (normally it has), prefetch the next one, evict all others.
+    void enterLevel(int level);
+
+    /// Upload prefetched textures whose decode finished (main thread, every frame)
+    void update();
+
+    bool isResident(std::size_t enemy) const;
+
+    /// Unload everything (Game::cleanUp)
+    void unloadAll();
+
+private:
+    void prefetch(std::size_t enemy);
+    void startDecode(Texture &tex);
+    void upload(Texture &tex);
+    void evict(std::size_t enemy);
+    void attach(const Texture &tex, const TextureHandle &handle);
+
+    Game &game_;
+    std::array<std::vector<Texture>, EnemyCount> textures_;  ///< per enemy
+    std::array<bool, EnemyCount>                 wanted_{};  ///< current or next
+};
+
+#endif
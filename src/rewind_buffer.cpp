@@ -0,0 +1,189 @@
+// rewind_buffer.cpp
+#include "rewind_buffer.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr std::size_t SnapshotBytes = sizeof(SimSnapshot);
+    constexpr std::size_t MaxRun        = 0xFFFF;
+    /// Zero runs shorter than this stay inside the literal (a token costs 4 bytes)
+    constexpr std::size_t MinZeroRun    = 4;
+
+    static_assert(SnapshotBytes <= MaxRun, "one token can cover a whole snapshot");
+
+    inline void putU16(std::vector<std::uint8_t> &out, std::size_t value)
+    {
+        out.push_back(std::uint8_t(value));
+        out.push_back(std::uint8_t(value >> 8));
+    }
+
+    inline std::size_t getU16(const std::uint8_t *p) { return std::size_t(p[0]) | std::size_t(p[1]) << 8; }
+
+    inline const std::uint8_t* bytesOf(const SimSnapshot &s) { return reinterpret_cast<const std::uint8_t*>(&s); }
+    inline std::uint8_t*       bytesOf(SimSnapshot &s)       { return reinterpret_cast<std::uint8_t*>(&s); }
+}
+
+void RewindBuffer::reset(int capacity, int keyframeInterval)
+{
+    capacity_ = std::max(capacity, 0);
+    interval_ = std::max(keyframeInterval, 1);
+    segments_.clear();
+    segments_.shrink_to_fit();
+    if (capacity_ > 0)
+    {
+        // one more than needed: the oldest may be partly overwritten history
+        segments_.resize(std::size_t((capacity_ + interval_ - 1) / interval_ + 1));
+        for (Segment &segment : segments_)
+        {
+            segment.offsets.reserve(std::size_t(interval_));
+            segment.inputs.reserve(std::size_t(interval_));
+        }
+    }
+    head_ = used_ = size_ = 0;
+}
+
+void RewindBuffer::clear()
+{
+    for (Segment &segment : segments_)
+    {
+        segment.data.clear();
+        segment.offsets.clear();
+        segment.inputs.clear();
+    }
+    head_ = used_ = size_ = 0;
+}
+
+std::size_t RewindBuffer::bytes() const
+{
+    std::size_t total = 0;
+    for (const Segment &segment : segments_) total += segment.data.size();
+    return total;
+}
+
+//------------------------------------------------------------------------------
+// Push / pop
+//------------------------------------------------------------------------------
+void RewindBuffer::push(const SimSnapshot &state, InputSnapshot input)
+{
+    if (capacity_ == 0) return;
+    PROFILE_ZONE("RewindBuffer::push");
+
+    if (used_ == 0 || newest().offsets.size() >= std::size_t(interval_))
+    {
+        // new segment, over the oldest one when every segment is in use
+        if (used_ > 0) head_ = (head_ + 1) % int(segments_.size());
+        if (used_ == int(segments_.size()))
+        {
+            size_ -= int(newest().offsets.size());
+            used_--;
+        }
+        Segment &segment = newest();
+        segment.data.clear();
+        segment.offsets.clear();
+        segment.inputs.clear();
+        used_++;
+
+        key_ = state;
+        segment.offsets.push_back(0);
+        segment.inputs.push_back(input);
+        encode(bytesOf(key_), segment.data);
+    }
+    else
+    {
+        Segment &segment = newest();
+        const std::uint8_t *now = bytesOf(state), *key = bytesOf(key_);
+        std::uint8_t       *delta = bytesOf(delta_);
+        for (std::size_t i = 0; i < SnapshotBytes; i++) delta[i] = now[i] ^ key[i];
+
+        segment.offsets.push_back(std::uint32_t(segment.data.size()));
+        segment.inputs.push_back(input);
+        encode(delta, segment.data);
+    }
+    size_++;
+}
+
+bool RewindBuffer::pop(SimSnapshot &state, InputSnapshot &input)
+{
+    if (size_ == 0) return false;
+    PROFILE_ZONE("RewindBuffer::pop");
+
+    Segment &segment = newest();
+    const std::size_t last = segment.offsets.size() - 1;
+    input = segment.inputs[last];
+    state = key_;
+    if (last > 0)
+    {
+        const std::uint8_t *begin = segment.data.data() + segment.offsets[last];
+        decode(begin, segment.data.data() + segment.data.size(), bytesOf(state));
+    }
+
+    segment.data.resize(segment.offsets[last]);
+    segment.offsets.pop_back();
+    segment.inputs.pop_back();
+    size_--;
+
+    if (segment.offsets.empty())
+    {
+        // the keyframe went out: the segment before is the newest now
+        used_--;
+        if (used_ > 0)
+        {
+            head_ = (head_ + int(segments_.size()) - 1) % int(segments_.size());
+            loadKey();
+        }
+    }
+    return true;
+}
+
+void RewindBuffer::loadKey()
+{
+    const Segment &segment = newest();
+    const std::uint8_t *begin = segment.data.data();
+    const std::uint8_t *end   = begin + (segment.offsets.size() > 1 ? segment.offsets[1] : segment.data.size());
+    std::memset(bytesOf(key_), 0, SnapshotBytes);
+    decode(begin, end, bytesOf(key_));
+}
+
+//------------------------------------------------------------------------------
+// RLE
+//------------------------------------------------------------------------------
+void RewindBuffer::encode(const std::uint8_t *raw, Bytes &out)
+{
+    std::size_t i = 0;
+    while (i < SnapshotBytes)
+    {
+        const std::size_t zerosFrom = i;
+        while (i < SnapshotBytes && raw[i] == 0) i++;
+        if (i == SnapshotBytes) break;  // trailing zeros: nothing to XOR in
+
+        // literal up to the next zero run worth a token of its own
+        const std::size_t literalFrom = i;
+        while (i < SnapshotBytes)
+        {
+            std::size_t zeros = 0;
+            while (i + zeros < SnapshotBytes && zeros < MinZeroRun && raw[i + zeros] == 0) zeros++;
+            if (zeros == MinZeroRun || i + zeros == SnapshotBytes) break;
+            i += zeros + 1;
+        }
+
+        putU16(out, literalFrom - zerosFrom);
+        putU16(out, i - literalFrom);
+        out.insert(out.end(), raw + literalFrom, raw + i);
+    }
+}
+
+void RewindBuffer::decode(const std::uint8_t *begin, const std::uint8_t *end, std::uint8_t *raw)
+{
+    std::size_t at = 0;
+    while (begin + 4 <= end)
+    {
+        at += getU16(begin);
+        const std::size_t count = getU16(begin + 2);
+        begin += 4;
+        for (std::size_t k = 0; k < count; k++) raw[at + k] ^= begin[k];
+        at    += count;
+        begin += count;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef _REWIND_BUFFER_H_
+#define _REWIND_BUFFER_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "platform_handler.hpp"
+#include "settings.hpp"
+#include "sim_snapshot.hpp"
+
+//------------------------------------------------------------------------------
+// RewindBuffer: the last `capacity` ticks of the simulation, newest first out.
+//
+// Each entry is the SimSnapshot at the start of a tick plus that tick's input.
+// Ticks are grouped in segments of `keyframeInterval`: the first snapshot of a
+// segment (the keyframe) is stored run-length encoded, the others as the RLE
+// of their XOR with it. Consecutive ticks differ in a few dozen bytes, so a
+// delta is mostly one long zero run. Any entry decodes from its keyframe and
+// its own delta alone, so pop() costs the same wherever it lands.
+//
+// RLE stream: [uint16 zero bytes][uint16 n][n literal bytes], repeated.
+//
+// When full, the oldest segment is dropped. Segments keep their storage, so
+// once every segment has been used push() and pop() no longer allocate.
+//------------------------------------------------------------------------------
+class RewindBuffer {
+public:
+    /// Off (capacity 0) until reset()
+    RewindBuffer() = default;
+
+    /// Drop everything and keep `capacity` ticks from now on (0: off)
+    void reset(int capacity, int keyframeInterval = REWIND_KEYFRAME_INTERVAL);
+
+    /// Append the snapshot at the start of a tick and the input it ran with
+    void push(const SimSnapshot &state, InputSnapshot input);
+
+    /// Take the newest entry out. False if empty.
+    bool pop(SimSnapshot &state, InputSnapshot &input);
+
+    /// Forget every entry (storage is kept)
+    void clear();
+
+    inline int  capacity() const { return capacity_; }
+    inline int  size() const     { return size_; }
+    inline bool empty() const    { return size_ == 0; }
+
+    /// Encoded bytes held right now
+    std::size_t bytes() const;
+
+private:
+    using Bytes = std::vector<std::uint8_t>;
+
+    struct Segment {
+        Bytes                       data;      ///< keyframe, then every delta
+        std::vector<std::uint32_t>  offsets;   ///< where each entry starts in data
+        std::vector<InputSnapshot>  inputs;
+    };
+
+    static void encode(const std::uint8_t *raw, Bytes &out);
+    /// XOR the decoded stream [begin, end) into `raw`
+    static void decode(const std::uint8_t *begin, const std::uint8_t *end, std::uint8_t *raw);
+
+    /// Decode the newest segment's keyframe into key_
+    void loadKey();
+
+    inline Segment& newest() { return segments_[std::size_t(head_)]; }
+
+    std::vector<Segment> segments_;
+    int                  interval_ = 1;
+    int                  capacity_ = 0;
+    int                  head_     = 0;  ///< newest segment
+    int                  used_     = 0;  ///< segments holding entries
+    int                  size_     = 0;  ///< entries held
+    SimSnapshot          key_{};         ///< the newest segment's keyframe, decoded
+    SimSnapshot          delta_{};       ///< scratch: state XOR key_
+};
+
+#endif
@@ -0,0 +1,291 @@
+// rollback_session.cpp
+#include "rollback_session.hpp"
+#include "game_handler.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace {
+    constexpr std::uint32_t NetMagic        = 0x504E464B;  ///< "KFNP"
+    constexpr int           MaxPacketInputs = 32;
+
+    /// What both peers' snapshots have to agree on for checksums to compare:
+    /// SnapshotVersion, and the size in case a layout change missed the bump
+    constexpr std::uint32_t SnapshotLayout  = SnapshotVersion << 16 | std::uint32_t(sizeof(SimSnapshot));
+
+    static_assert(SnapshotVersion <= 0xFFFF && sizeof(SimSnapshot) <= 0xFFFF, "snapshot layout fits 32 bits");
+
+    enum PacketType : std::uint8_t {
+        Hello   = 1,  ///< guest → host until welcomed (value: SnapshotLayout)
+        Welcome = 2,  ///< host → guest, answers every Hello (value: the seed)
+        Inputs  = 3,  ///< both ways, every tick once connected
+    };
+
+    /// Every datagram: this header, then `count` InputSnapshot::bits
+    struct PacketHeader {
+        std::uint32_t magic;
+        std::uint8_t  type;
+        std::uint8_t  count;
+        std::uint16_t reserved;
+        std::uint32_t value;       ///< Hello / Welcome payload
+        std::int32_t  frame;       ///< frame of the first input
+        std::int32_t  ack;         ///< the sender has our inputs for frames before this
+        std::int32_t  checkFrame;  ///< a final frame of the sender's, -1 if none yet
+        std::uint64_t checksum;    ///< of the sender's simulation at checkFrame
+    };
+
+    static_assert(sizeof(PacketHeader) == 32, "packet header layout");
+    static_assert(sizeof(PacketHeader) + MaxPacketInputs * sizeof(std::uint16_t) <= MaxDatagramSize,
+                  "a full packet fits one datagram");
+}
+
+RollbackSession::RollbackSession(Game &game, NetTransport &transport, int localPlayer,
+                                 int inputDelay, int maxRollback)
+    : game_(game)
+    , transport_(transport)
+    , local_(localPlayer)
+    , inputDelay_(std::clamp(inputDelay, 0, InputRing / 4))
+    , maxRollback_(std::clamp(maxRollback, 1, InputRing / 4))
+    , snapshots_(std::size_t(maxRollback_ + 2))
+{
+    // Neither peer has input for the first inputDelay frames: known, and empty
+    localEnd_ = confirmed_ = remoteAck_ = inputDelay_;
+}
+
+void RollbackSession::tick(InputSnapshot local)
+{
+    PROFILE_ZONE("RollbackSession::tick");
+    transport_.update(game_.platform.now());
+    receive();
+    if (!connected_)
+    {
+        if (local_ == 1) sendControl(Hello, SnapshotLayout);
+        idle();
+        return;
+    }
+
+    // Too far ahead of the peer: wait, keeping what was pressed meanwhile
+    pending_.bits |= local.bits;
+    const bool stalled = frame_ - confirmed_ >= maxRollback_ || localEnd_ - remoteAck_ >= MaxPacketInputs;
+    if (!stalled)
+    {
+        localInputs_[std::size_t(localEnd_ % InputRing)] = pending_;
+        localEnd_++;
+        pending_ = {};
+    }
+    sendInputs();
+
+    rollback(stalled);
+    if (stalled)
+    {
+        stats_.stalls++;
+        idle();
+    }
+    else
+    {
+        simulate(frame_);
+        frame_++;
+    }
+    checkConfirmed();
+}
+
+void RollbackSession::idle()
+{
+    // Nothing to simulate: give the peer's packets a moment (headless runs
+    // would otherwise race through their frames while waiting)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+//------------------------------------------------------------------------------
+// Packets
+//------------------------------------------------------------------------------
+void RollbackSession::receive()
+{
+    std::uint8_t buffer[MaxDatagramSize];
+    while (std::size_t size = transport_.receive(buffer, sizeof(buffer)))
+    {
+        PacketHeader header;
+        if (size < sizeof(header)) continue;
+        std::memcpy(&header, buffer, sizeof(header));
+        if (header.magic != NetMagic) continue;
+
+        switch (header.type)
+        {
+            case Hello:
+                if (local_ != 0) break;
+                if (header.value != SnapshotLayout)
+                {
+                    std::fprintf(stderr, "versus: ignoring a peer with another snapshot layout "
+                                         "(version %u, %u bytes; ours: version %u, %u bytes)\n",
+                                 unsigned(header.value >> 16), unsigned(header.value & 0xFFFF),
+                                 unsigned(SnapshotVersion), unsigned(sizeof(SimSnapshot)));
+                    break;
+                }
+                if (!connected_)
+                {
+                    game_.startVersus(game_.seed);
+                    connected_ = true;
+                }
+                sendControl(Welcome, game_.seed);  // again for every Hello: Welcomes get lost too
+                break;
+
+            case Welcome:
+                if (local_ != 1 || connected_) break;
+                game_.startVersus(header.value);
+                connected_ = true;
+                break;
+
+            case Inputs:
+            {
+                if (header.count > MaxPacketInputs
+                    || size < sizeof(header) + header.count * sizeof(std::uint16_t))
+                    break;
+                std::uint16_t inputs[MaxPacketInputs];
+                std::memcpy(inputs, buffer + sizeof(header), header.count * sizeof(std::uint16_t));
+                onInputs(header.frame, inputs, header.count);
+                remoteAck_ = std::max(remoteAck_, std::min(int(header.ack), localEnd_));
+                onCheck(header.checkFrame, header.checksum);
+                break;
+            }
+        }
+    }
+}
+
+void RollbackSession::onInputs(std::int32_t first, const std::uint16_t *inputs, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const int f = first + i;
+        if (f < confirmed_) continue;                                  // already known
+        if (f > confirmed_ || f >= frame_ + InputRing / 2) break;     // past a lost packet
+
+        InputSnapshot input;
+        input.bits = inputs[i];
+        remoteInputs_[std::size_t(f % InputRing)] = input;
+        if (f < frame_ && predicted_[std::size_t(f % InputRing)].bits != input.bits)
+            rollbackTo_ = std::min(rollbackTo_, f);
+        confirmed_++;
+    }
+}
+
+void RollbackSession::sendControl(std::uint8_t type, std::uint32_t value)
+{
+    PacketHeader header{};
+    header.magic      = NetMagic;
+    header.type       = type;
+    header.value      = value;
+    header.checkFrame = -1;
+    transport_.send(&header, sizeof(header));
+}
+
+void RollbackSession::sendInputs()
+{
+    // Everything the peer has not acked yet, so a lost packet costs nothing
+    std::uint8_t buffer[sizeof(PacketHeader) + MaxPacketInputs * sizeof(std::uint16_t)];
+    const int count = std::min(localEnd_ - remoteAck_, MaxPacketInputs);
+
+    PacketHeader header{};
+    header.magic      = NetMagic;
+    header.type       = Inputs;
+    header.count      = std::uint8_t(count);
+    header.frame      = remoteAck_;
+    header.ack        = confirmed_;
+    header.checkFrame = lastCheck_.frame;
+    header.checksum   = lastCheck_.sum;
+    std::memcpy(buffer, &header, sizeof(header));
+    for (int i = 0; i < count; i++)
+    {
+        const std::uint16_t bits = localInputs_[std::size_t((remoteAck_ + i) % InputRing)].bits;
+        std::memcpy(buffer + sizeof(header) + i * sizeof(bits), &bits, sizeof(bits));
+    }
+    transport_.send(buffer, sizeof(header) + std::size_t(count) * sizeof(std::uint16_t));
+}
+
+//------------------------------------------------------------------------------
+// Simulation
+//------------------------------------------------------------------------------
+InputSnapshot RollbackSession::remoteInput(int f) const
+{
+    if (f < confirmed_) return remoteInputs_[std::size_t(f % InputRing)];
+
+    // Prediction: keys held in the last known input stay held, none is released
+    InputSnapshot guess;
+    guess.bits = remoteInputs_[std::size_t((confirmed_ - 1 + InputRing) % InputRing)].bits
+               & std::uint16_t((1u << KeyCount) - 1);
+    return guess;
+}
+
+void RollbackSession::simulate(int f)
+{
+    game_.capture(snapshot(f));
+
+    const InputSnapshot mine   = localInputs_[std::size_t(f % InputRing)];
+    const InputSnapshot theirs = remoteInput(f);
+    predicted_[std::size_t(f % InputRing)] = theirs;
+    if (local_ == 0) game_.advance(mine, theirs);
+    else             game_.advance(theirs, mine);
+}
+
+void RollbackSession::rollback(bool showLast)
+{
+    if (rollbackTo_ >= frame_) return;
+    PROFILE_ZONE("RollbackSession::rollback");
+
+    const int depth = frame_ - rollbackTo_;
+    stats_.rollbacks++;
+    stats_.resimulated += std::uint64_t(depth);
+    stats_.maxDepth     = std::max(stats_.maxDepth, depth);
+
+    // Only the frame on screen is drawn (and heard); when no new frame
+    // follows this tick, that is the last resimulated one
+    game_.restore(snapshot(rollbackTo_));
+    for (int f = rollbackTo_; f < frame_; f++)
+    {
+        game_.muteOutput(showLast && f + 1 == frame_ ? Mute::None : Mute::Draws | Mute::Sounds);
+        simulate(f);
+    }
+    game_.muteOutput(Mute::None);
+    rollbackTo_ = NoRollback;
+}
+
+//------------------------------------------------------------------------------
+// Desync detection: the state at the start of frame f is final once the
+// peer's inputs before f are known
+//------------------------------------------------------------------------------
+void RollbackSession::checkConfirmed()
+{
+    const int last = std::min(confirmed_, frame_ - 1);
+    for (int f = checkedTo_ + 1; f <= last; f++)
+    {
+        if (f % ChecksumInterval != 0) continue;
+        const std::size_t slot = std::size_t(f / ChecksumInterval % CheckRing);
+        localChecks_[slot] = { f, checksum(snapshot(f)) };
+        lastCheck_         = localChecks_[slot];
+        compare(localChecks_[slot], remoteChecks_[slot]);
+    }
+    checkedTo_ = std::max(checkedTo_, last);
+}
+
+void RollbackSession::onCheck(std::int32_t frame, std::uint64_t sum)
+{
+    if (frame < 0 || frame % ChecksumInterval != 0) return;
+    const std::size_t slot = std::size_t(frame / ChecksumInterval % CheckRing);
+    if (remoteChecks_[slot].frame == frame) return;  // repeated by every packet until the next one
+    remoteChecks_[slot] = { frame, sum };
+    compare(localChecks_[slot], remoteChecks_[slot]);
+}
+
+void RollbackSession::compare(const Check &local, const Check &remote)
+{
+    if (local.frame < 0 || local.frame != remote.frame) return;
+    stats_.checksums++;
+    if (local.sum != remote.sum && stats_.desyncFrame < 0)
+    {
+        stats_.desyncFrame = local.frame;
+        std::fprintf(stderr, "versus: desync at frame %d\n", local.frame);
+    }
+}
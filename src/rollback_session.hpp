@@ -0,0 +1,109 @@
+#ifndef _ROLLBACK_SESSION_H_
+#define _ROLLBACK_SESSION_H_
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "net_transport.hpp"
+#include "platform_handler.hpp"
+#include "settings.hpp"
+#include "sim_snapshot.hpp"
+
+class Game;
+
+/// What a versus session has done so far
+struct NetplayStats {
+    std::uint64_t rollbacks   = 0;   ///< mispredicted remote inputs corrected
+    std::uint64_t resimulated = 0;   ///< frames simulated again because of them
+    int           maxDepth    = 0;   ///< longest rollback, in frames
+    std::uint64_t stalls      = 0;   ///< ticks spent waiting for the peer
+    std::uint64_t checksums   = 0;   ///< confirmed frames compared with the peer
+    std::int32_t  desyncFrame = -1;  ///< first frame whose state differed, -1 if none
+};
+
+//------------------------------------------------------------------------------
+// RollbackSession: two-player versus over a NetTransport, GGPO style.
+//
+// Player 0 plays the hero and hosts (the seed is its), player 1 plays the
+// enemy. Each peer only has to wait for its own input: local input is held
+// back `inputDelay` frames and sent with every packet until acked, so lost
+// datagrams are covered by the next one. The peer's input for a frame not
+// heard of yet is predicted (its held keys stay held). When the real input
+// differs, the session restores the snapshot of that frame and simulates up
+// to the present again with output muted (Game::muteOutput), all within one
+// tick. A peer more than `maxRollback` frames ahead of what it knows waits.
+//
+// Every ChecksumInterval confirmed frames both peers exchange a checksum of
+// the simulation (sim_snapshot.hpp) to catch a desync.
+//------------------------------------------------------------------------------
+class RollbackSession {
+public:
+    RollbackSession(Game &game, NetTransport &transport, int localPlayer,
+                    int inputDelay = NETPLAY_INPUT_DELAY, int maxRollback = NETPLAY_MAX_ROLLBACK);
+
+    /// One game tick: exchange packets, correct mispredictions, then simulate
+    /// the next frame with `local` as this peer's input. Until both peers are
+    /// connected (and while too far ahead) only talks to the peer.
+    void tick(InputSnapshot local);
+
+    inline bool                isConnected() const { return connected_; }
+    inline int                 frame() const       { return frame_; }      ///< next frame to simulate
+    inline int                 confirmed() const   { return confirmed_; }  ///< peer inputs known up to here
+    inline const NetplayStats& stats() const       { return stats_; }
+
+private:
+    static constexpr int InputRing        = 64;  ///< frames of input kept per player
+    static constexpr int ChecksumInterval = 30;
+    static constexpr int CheckRing        = 16;
+    static constexpr int NoRollback       = 0x7FFFFFFF;
+
+    struct Check {
+        std::int32_t  frame = -1;
+        std::uint64_t sum   = 0;
+    };
+
+    void idle();
+    void receive();
+    void onInputs(std::int32_t first, const std::uint16_t *inputs, int count);
+    void onCheck(std::int32_t frame, std::uint64_t sum);
+    void sendControl(std::uint8_t type, std::uint32_t value);
+    void sendInputs();
+
+    /// Restore the first mispredicted frame and simulate up to frame_ again
+    /// (muted, but for the last frame when `showLast`)
+    void rollback(bool showLast);
+    /// Snapshot frame `f`, then simulate it with the best inputs known
+    void simulate(int f);
+    /// Checksum frames that became final, compare with the peer's
+    void checkConfirmed();
+    void compare(const Check &local, const Check &remote);
+
+    InputSnapshot remoteInput(int f) const;
+    inline SimSnapshot& snapshot(int f) { return snapshots_[std::size_t(f) % snapshots_.size()]; }
+
+    Game          &game_;
+    NetTransport  &transport_;
+    const int      local_;
+    const int      inputDelay_;
+    const int      maxRollback_;
+
+    bool           connected_   = false;
+    int            frame_       = 0;   ///< next frame to simulate
+    int            localEnd_    = 0;   ///< local inputs known for frames before this
+    int            confirmed_   = 0;   ///< remote inputs known for frames before this
+    int            remoteAck_   = 0;   ///< the peer has our inputs for frames before this
+    int            rollbackTo_  = NoRollback;  ///< earliest mispredicted frame
+    int            checkedTo_   = -1;  ///< frames up to here have been checksummed
+    InputSnapshot  pending_;           ///< local keys pressed while stalled
+
+    std::array<InputSnapshot, InputRing> localInputs_{}, remoteInputs_{}, predicted_{};
+    std::array<Check, CheckRing>         localChecks_{}, remoteChecks_{};
+    Check                                lastCheck_;   ///< newest local check, sent with inputs
+    std::vector<SimSnapshot>             snapshots_;   ///< start of each of the last frames
+    NetplayStats                         stats_;
+};
+
+#endif
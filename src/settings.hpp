@@ -14,9 +14,29 @@ constexpr int SCREEN_WIDTH     = 1024;
 constexpr int SCREEN_HEIGHT    =  768;
 constexpr int GAME_WIDTH       = 256;
 constexpr int GAME_HEIGHT      = 256;
-constexpr int TARGET_FPS       = 60;
+constexpr int TARGET_FPS       = 60;   // simulation ticks per second (render rate is the display's)
 constexpr int FRAME_SPEED      =  5;
 
+constexpr unsigned int LOADER_THREADS    = 0;     // asset decode workers, 0 = one per core
+constexpr bool         PRINT_LOAD_REPORT = false; // per-asset startup timings on stdout, every Game
+
+constexpr char PROFILE_TRACE_FILE[] = "kungfu_trace.json"; // KUNGFU_PROFILE builds: F9 / exit
+
+constexpr char          SOFTWARE_FRAME_FILE[]   = "kungfu_frame.ppm"; // last frame of a --software run
+constexpr unsigned long SOFTWARE_DEFAULT_FRAMES = 600;                // --software run length without raylib
+constexpr int           PRESENT_NEAREST_FACTOR  = SCREEN_HEIGHT / GAME_HEIGHT; // --upscale nearest
+constexpr int           CAPTURE_SLOTS           = 16;  // --capture: frames buffered for the writer thread
+
+constexpr int PARTICLE_CAPACITY = 512;  // live hit sparks at most
+constexpr int HIT_SPARKS        = 12;   // sparks per landed hit
+
+constexpr int NETPLAY_INPUT_DELAY  = 2;  // --versus: ticks local input is held back (hides that much latency)
+constexpr int NETPLAY_MAX_ROLLBACK = 8;  // --versus: ticks predicted past the peer's input before waiting
+
+constexpr int REWIND_SECONDS           = 60;  // Game::setRewind() default; the game keeps none without --rewind
+constexpr int REWIND_KEYFRAME_INTERVAL = 60;  // --rewind: ticks per full snapshot, the rest are deltas
+
+constexpr unsigned int REPLAY_KEYFRAME_INTERVAL = 600;  // --record: ticks between full snapshots (a seek simulates fewer)
 
 
 #endif
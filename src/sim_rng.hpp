@@ -0,0 +1,63 @@
+#ifndef _SIM_RNG_H_
+#define _SIM_RNG_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// SimRng: the simulation's random numbers (Game::rng).
+//
+// MT19937 with the same seeding and output as std::mt19937, but its state is
+// plain 32-bit words. std::mt19937 keeps uint_fast32_t words, 8 bytes on
+// 64-bit glibc and 4 with MSVC, so a snapshot holding one would change layout
+// between builds. This one is 2.5 KB everywhere, and copies as bytes.
+//------------------------------------------------------------------------------
+class SimRng {
+public:
+    static constexpr std::size_t   StateSize   = 624;
+    static constexpr std::uint32_t DefaultSeed = 5489u;  ///< std::mt19937's
+
+    /// Unseeded, like any plain struct (all zero when value-initialized)
+    SimRng() = default;
+    explicit SimRng(std::uint32_t value) { seed(value); }
+
+    void seed(std::uint32_t value)
+    {
+        state_[0] = value;
+        for (std::size_t i = 1; i < StateSize; i++)
+            state_[i] = 1812433253u * (state_[i - 1] ^ (state_[i - 1] >> 30)) + std::uint32_t(i);
+        index_ = StateSize;
+    }
+
+    std::uint32_t operator()()
+    {
+        if (index_ >= StateSize) twist();
+        std::uint32_t y = state_[index_++];
+        y ^= y >> 11;
+        y ^= (y << 7)  & 0x9D2C5680u;
+        y ^= (y << 15) & 0xEFC60000u;
+        return y ^ (y >> 18);
+    }
+
+    /// False for a state no seed leads to (e.g. a corrupt snapshot)
+    inline bool valid() const { return index_ <= StateSize; }
+
+private:
+    static constexpr std::size_t Shift = 397;
+
+    void twist()
+    {
+        for (std::size_t i = 0; i < StateSize; i++) {
+            std::uint32_t y = (state_[i] & 0x80000000u) | (state_[(i + 1) % StateSize] & 0x7FFFFFFFu);
+            state_[i] = state_[(i + Shift) % StateSize] ^ (y >> 1) ^ ((y & 1u) ? 0x9908B0DFu : 0u);
+        }
+        index_ = 0;
+    }
+
+    std::uint32_t state_[StateSize];
+    std::uint32_t index_;
+};
+
+#endif
@@ -0,0 +1,31 @@
+// sim_snapshot.cpp
+#include "sim_snapshot.hpp"
+
+#include <cstring>
+
+//------------------------------------------------------------------------------
+// Multiply-xor over 8-byte words in four independent lanes, so the multiplies
+// overlap instead of waiting on each other; the lanes are folded at the end.
+//------------------------------------------------------------------------------
+std::uint64_t checksum(const SimSnapshot &snapshot)
+{
+    constexpr std::uint64_t Prime = 0x100000001B3ull;  // FNV-1a 64-bit prime
+    std::uint64_t lanes[4] = { 0xCBF29CE484222325ull, 0x9E3779B97F4A7C15ull,
+                               0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull };
+
+    const auto       *bytes = reinterpret_cast<const unsigned char*>(&snapshot);
+    const std::size_t size  = sizeof(snapshot);
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int k = 0; k < 4; k++) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i + k * 8, 8);
+            lanes[k] = (lanes[k] ^ word) * Prime;
+        }
+    }
+    for (; i < size; i++) lanes[0] = (lanes[0] ^ bytes[i]) * Prime;
+
+    std::uint64_t hash = lanes[0];
+    for (int k = 1; k < 4; k++) hash = (hash ^ (lanes[k] >> 29) ^ lanes[k]) * Prime;
+    return hash ^ (hash >> 32);
+}
@@ -0,0 +1,122 @@
+#ifndef _SIM_SNAPSHOT_H_
+#define _SIM_SNAPSHOT_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "asset_ids.hpp"
+#include "sim_rng.hpp"
+#include "sprite_handler.hpp"
+
+//------------------------------------------------------------------------------
+// Game‐state identifiers (Game::state; stored in snapshots and replay starts)
+//------------------------------------------------------------------------------
+enum class GameState : int {
+    Intro = 0,   ///< Title/intro screen
+    Preview = 1, ///< “Get ready” screen before each level
+    Play = 2     ///< Actual gameplay
+};
+
+//------------------------------------------------------------------------------
+// SimSnapshot: everything the simulation reads from one tick to the next,
+// as one fixed-size block of plain data.
+//
+// Game::capture fills it, Game::restore puts it back; feeding the same inputs
+// after a restore reproduces the same ticks. Both are straight field copies
+// (a few KB, most of it the RNG), cheap enough to take every tick for
+// rollback, run-ahead and rewind.
+//
+// Not included: what is derived or presentation only - textures and their
+// residency, render caches (static layer, HUD surface), hit sparks, music
+// and sound playback, the FramePacer's recorded draws.
+//
+// A snapshot can be restored into any Game, also one that never ran the
+// restored state's init() (a replay seek in a fresh process): what drawing
+// needs besides the snapshot is set up when Game is constructed (HUD
+// bindings, sprite speeds) or rebuilt from the restored values (enemy
+// textures, static layer, HUD surface), so the next tick looks as it did
+// live. Music is not: it keeps playing (or not) as it was.
+//
+// Every field has a fixed width and the structs have no padding, so equal
+// simulations give byte-equal snapshots and checksum() can hash raw bytes.
+// The layout is the same on every build (the RNG is SimRng's 32-bit words),
+// so replay keyframes and versus peers work across platforms.
+// SnapshotVersion changes whenever a field is added.
+//------------------------------------------------------------------------------
+constexpr std::uint32_t SnapshotMagic   = 0x5053464B;  ///< "KFSP"
+constexpr std::uint32_t SnapshotVersion = 2;
+
+/// SpriteAnim
+struct AnimSnapshot {
+    std::int32_t x, y, frame, timer, speed;
+    std::uint8_t flipped, paused, reserved[2];
+};
+
+/// Timer + State bookkeeping shared by every game state
+struct StateSnapshot {
+    std::int32_t frameCounter, elapsedSeconds;
+    std::uint8_t initialized, reserved[3];
+};
+
+struct IntroSnapshot {
+    StateSnapshot base;
+    std::int32_t  blinkFrameTimer, blinkCurrFrame, blinkCount;
+    std::uint8_t  blinkEnter, canProceed, reserved[2];
+};
+
+struct PreviewSnapshot {
+    StateSnapshot base;
+};
+
+struct PlaySnapshot {
+    StateSnapshot base;
+    std::int32_t  enemyHealth, enemyX, enemyY, enemyCurrentMove, enemyRandomAttack;
+    std::int32_t  enemyMoveState, endState, enemyEndState;
+    std::int32_t  retreatCounter, runCounter, haltTime, haltTimeHit, maxHaltTime;
+    std::int32_t  rotatingChainX, rotatingChainY;
+    std::uint8_t  isEnemyFlipped, pauseMovement, renderEnemyHit, reserved;
+    AnimSnapshot  enemyAnims[EnemyCount][EnemyPoseCount];
+    AnimSnapshot  chainAnim;
+};
+
+struct PlayerSnapshot {
+    std::int32_t  frameCounter, elapsedSeconds;  ///< Timer
+    std::int32_t  x, oldX, y, lives, health, bonusScore, lifeCounter;
+    std::int32_t  activateTime, currAction, prevAction, jumpDrift;
+    std::int32_t  pauseTimer, stunJumpTimer, jumpFrameCounter, jumpAcceleration;
+    std::uint8_t  controlsLocked, canAttack, attackActive, isInverted;
+    std::uint8_t  isShaking, shakeDirRight, showHit, isFlyingKick;
+    std::uint8_t  canFlyKick, reserved[3];
+    AnimSnapshot  walkAnim, defeatedAnim, hitAnim;
+};
+
+struct SimSnapshot {
+    std::uint32_t   magic;
+    std::uint32_t   version;
+    std::int32_t    state, level, score;   ///< Game (state is a GameState)
+    std::uint32_t   seed;
+    SimRng          rng;
+    IntroSnapshot   intro;
+    PreviewSnapshot preview;
+    PlaySnapshot    play;
+    PlayerSnapshot  player;
+};
+
+static_assert(std::is_trivially_copyable_v<SimSnapshot>, "snapshots are copied as bytes");
+static_assert(std::has_unique_object_representations_v<SimSnapshot>,
+              "snapshot has padding: add reserved bytes so equal states hash equal");
+
+inline AnimSnapshot toSnapshot(const SpriteAnim &a) {
+    return { a.x, a.y, a.frame, a.timer, a.speed, a.flipped, a.paused, {} };
+}
+inline SpriteAnim fromSnapshot(const AnimSnapshot &a) {
+    return { a.x, a.y, a.frame, a.timer, a.speed, a.flipped != 0, a.paused != 0 };
+}
+
+/// 64-bit hash of the whole snapshot (e.g. to compare two peers' states)
+std::uint64_t checksum(const SimSnapshot &snapshot);
+
+#endif
@@ -0,0 +1,196 @@
+// software_platform.cpp
+#include "software_platform.hpp"
+#include "png_decoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr std::uint32_t AlphaMask   = 0xFF000000u;
+    constexpr std::uint32_t OpaqueBlack = 0xFF000000u;
+
+    //--------------------------------------------------------------------------
+    // Copy the n pixels of `src` whose alpha is non-zero over `dst`.
+    // Mirrored rows read `src` backwards: src[0], src[-1], ... src[-(n-1)].
+    //--------------------------------------------------------------------------
+    inline void blitRow(std::uint32_t *dst, const std::uint32_t *src, int n, bool mirrored)
+    {
+        int k = 0;
+#if defined(__SSE2__)
+        const __m128i alpha = _mm_set1_epi32(int(AlphaMask));
+        const __m128i zero  = _mm_setzero_si128();
+        for (; k + 4 <= n; k += 4) {
+            __m128i s = mirrored
+                ? _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src - k - 3)),
+                                    _MM_SHUFFLE(0, 1, 2, 3))
+                : _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + k));
+            __m128i d     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + k));
+            __m128i clear = _mm_cmpeq_epi32(_mm_and_si128(s, alpha), zero);
+            d = _mm_or_si128(_mm_and_si128(clear, d), _mm_andnot_si128(clear, s));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k), d);
+        }
+#endif
+        for (; k < n; k++) {
+            std::uint32_t s = mirrored ? src[-k] : src[k];
+            dst[k] = (s & AlphaMask) ? s : dst[k];
+        }
+    }
+}
+
+SoftwarePlatform::SoftwarePlatform(unsigned long frameLimit)
+    : frameLimit(frameLimit)
+    , frame_(std::size_t(GAME_WIDTH) * GAME_HEIGHT, OpaqueBlack)
+{
+}
+
+//------------------------------------------------------------------------------
+// Frame
+//------------------------------------------------------------------------------
+void SoftwarePlatform::beginFrame()
+{
+    std::fill(frame_.begin(), frame_.end(), OpaqueBlack);
+}
+
+void SoftwarePlatform::endFrame()
+{
+    // "released" is only true for the frame right after a key goes up
+    prevKeys_ = keys_;
+    frames++;
+    if (capture_ != nullptr) capture_->submit(frame_.data());
+    if (cpuPresent_) upscaler_.run(frame_.data(), GAME_WIDTH, GAME_HEIGHT);
+    if (frameLimit != 0 && frames >= frameLimit) closeRequested = true;
+}
+
+void SoftwarePlatform::setPresentFilter(UpscaleFilter filter, int nearestFactor)
+{
+    upscaler_.setFilter(filter, nearestFactor);
+    cpuPresent_ = true;
+}
+
+bool SoftwarePlatform::savePpm(const std::string &path) const
+{
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) return false;
+
+    const std::uint32_t *pixels = presented();
+    const std::size_t    count  = std::size_t(presentedWidth()) * presentedHeight();
+    std::fprintf(f, "P6\n%d %d\n255\n", presentedWidth(), presentedHeight());
+    std::vector<unsigned char> rgb(count * 3);
+    for (std::size_t i = 0; i < count; i++) {
+        rgb[i * 3]     = (unsigned char)(pixels[i]);
+        rgb[i * 3 + 1] = (unsigned char)(pixels[i] >> 8);
+        rgb[i * 3 + 2] = (unsigned char)(pixels[i] >> 16);
+    }
+    std::fwrite(rgb.data(), 1, rgb.size(), f);
+    return std::fclose(f) == 0;
+}
+
+//------------------------------------------------------------------------------
+// Textures
+//------------------------------------------------------------------------------
+bool SoftwarePlatform::decodeImage(const std::string &path, PixelImage &out)
+{
+    return decodePngFile(path, out);
+}
+
+TextureHandle SoftwarePlatform::loadTexture(const std::string &path)
+{
+    PixelImage img;
+    if (!decodeImage(path, img)) return {};
+    return loadTextureFromPixels(img.width, img.height, img.rgba.data());
+}
+
+TextureHandle SoftwarePlatform::loadTextureFromPixels(int width, int height, const void *rgba)
+{
+    Surface s{ width, height, std::vector<std::uint32_t>(std::size_t(width) * height) };
+    const unsigned char *p = static_cast<const unsigned char*>(rgba);
+    for (std::uint32_t &px : s.pixels) {
+        px = std::uint32_t(p[0]) | (std::uint32_t(p[1]) << 8)
+           | (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+        p += 4;
+    }
+    return addSurface(std::move(s));
+}
+
+TextureHandle SoftwarePlatform::createRenderTarget(int width, int height)
+{
+    return addSurface({ width, height, std::vector<std::uint32_t>(std::size_t(width) * height) });
+}
+
+TextureHandle SoftwarePlatform::addSurface(Surface surface)
+{
+    TextureHandle handle{ unsigned(surfaces_.size()) + 1, surface.width, surface.height };
+    surfaces_.push_back(std::move(surface));
+    return handle;
+}
+
+void SoftwarePlatform::unloadTexture(TextureHandle &texture)
+{
+    if (Surface *s = findSurface(texture.id)) *s = {};
+    texture = {};
+}
+
+SoftwarePlatform::Surface* SoftwarePlatform::findSurface(unsigned int id)
+{
+    if (id == 0 || id > surfaces_.size()) return nullptr;
+    Surface &s = surfaces_[id - 1];
+    return s.pixels.empty() ? nullptr : &s;
+}
+
+void SoftwarePlatform::beginRenderTarget(const TextureHandle &target)
+{
+    Surface *s = findSurface(target.id);
+    if (s == nullptr) return;
+    std::fill(s->pixels.begin(), s->pixels.end(), 0u);
+    targetId_ = target.id;
+}
+
+//------------------------------------------------------------------------------
+// Drawing. Same conventions as raylib's DrawTextureRec: a negative src
+// width (a flipped SpriteAnim) mirrors [src.x, src.x + |width|),
+// a negative height flips rows the same way.
+//------------------------------------------------------------------------------
+void SoftwarePlatform::drawTexture(const TextureHandle &texture, const Rect &src,
+                                   float x, float y, DrawLayer)
+{
+    drawCalls++;
+    const Surface *tex = findSurface(texture.id);
+    if (tex == nullptr) return;
+
+    Surface       *target    = targetId_ ? findSurface(targetId_) : nullptr;
+    std::uint32_t *dstPixels = target ? target->pixels.data() : frame_.data();
+    const int      dstW      = target ? target->width  : GAME_WIDTH;
+    const int      dstH      = target ? target->height : GAME_HEIGHT;
+
+    const bool mirrorX = src.width  < 0;
+    const bool mirrorY = src.height < 0;
+    const int  w  = int(std::fabs(src.width));
+    const int  h  = int(std::fabs(src.height));
+    const int  sx = int(src.x);
+    const int  sy = int(src.y);
+    const int  dx = int(std::floor(x + 0.5f));
+    const int  dy = int(std::floor(y + 0.5f));
+
+    // Destination offsets [i0, i1) x [j0, j1) that land inside both the
+    // target and the source texture
+    int i0 = std::max(-dx, mirrorX ? sx + w - tex->width  : -sx);
+    int i1 = std::min(dstW - dx, mirrorX ? sx + w : tex->width - sx);
+    int j0 = std::max(-dy, mirrorY ? sy + h - tex->height : -sy);
+    int j1 = std::min(dstH - dy, mirrorY ? sy + h : tex->height - sy);
+    i0 = std::max(i0, 0); i1 = std::min(i1, w);
+    j0 = std::max(j0, 0); j1 = std::min(j1, h);
+    if (i0 >= i1 || j0 >= j1) return;
+
+    const int firstCol = mirrorX ? sx + w - 1 - i0 : sx + i0;
+    for (int j = j0; j < j1; j++) {
+        const int row = mirrorY ? sy + h - 1 - j : sy + j;
+        blitRow(dstPixels + std::size_t(dy + j) * dstW + (dx + i0),
+                tex->pixels.data() + std::size_t(row) * tex->width + firstCol,
+                i1 - i0, mirrorX);
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef _SOFTWARE_PLATFORM_H_
+#define _SOFTWARE_PLATFORM_H_
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "platform_handler.hpp"
+#include "frame_capture.hpp"
+#include "upscaler.hpp"
+
+//------------------------------------------------------------------------------
+// SoftwarePlatform: headless backend that really renders. Sprite sheets are
+// decoded to CPU memory and every draw is an alpha-keyed blit into a
+// GAME_WIDTH x GAME_HEIGHT framebuffer, so frames can be inspected or saved
+// without a window or GPU. Time advances one tick per frame (like
+// NullPlatform): runs are deterministic and as fast as the CPU allows.
+//
+// Pixels are packed as r | g << 8 | b << 16 | a << 24.
+//------------------------------------------------------------------------------
+class SoftwarePlatform : public Platform {
+public:
+    /// Stop after `frameLimit` presented frames (0 = until told to close)
+    explicit SoftwarePlatform(unsigned long frameLimit = 0);
+
+    void openWindow(int, int, const char *) override {}
+    void closeWindow() override {}
+    bool shouldClose() override { return closeRequested; }
+    double now() override { return double(frames) / TARGET_FPS; }
+
+    void beginFrame() override;
+    void endFrame() override;
+
+    bool isKeyDown(Key key) override     { return keys_[int(key)]; }
+    bool isKeyReleased(Key key) override { return prevKeys_[int(key)] && !keys_[int(key)]; }
+    bool isDebugKeyPressed(DebugKey) override { return false; }
+    bool isDebugKeyDown(DebugKey) override    { return false; }
+
+    bool decodeImage(const std::string &path, PixelImage &out) override;
+    bool decodeWave(const std::string &, PcmWave &) override { return true; }
+
+    TextureHandle loadTexture(const std::string &path) override;
+    TextureHandle loadTextureFromPixels(int width, int height, const void *rgba) override;
+    void unloadTexture(TextureHandle &texture) override;
+    TextureHandle createRenderTarget(int width, int height) override;
+    void beginRenderTarget(const TextureHandle &target) override;
+    void endRenderTarget() override { targetId_ = 0; }
+    void drawTexture(const TextureHandle &texture, const Rect &src,
+                     float x, float y, DrawLayer layer) override;
+
+    SoundHandle loadSound(const std::string &) override { return { soundCount_++ }; }
+    SoundHandle loadSoundFromPcm(unsigned int, unsigned int, unsigned int, unsigned int,
+                                 const void *) override { return { soundCount_++ }; }
+    void unloadSound(SoundHandle) override {}
+    void playSound(SoundHandle) override { soundsPlayed++; }
+
+    MusicHandle loadMusic(const std::string &) override { return { musicCount_++ }; }
+    MusicHandle loadMusicFromMemory(const char *, const void *, int) override { return { musicCount_++ }; }
+    void unloadMusic(MusicHandle) override {}
+    void playMusic(MusicHandle) override {}
+    void updateMusic(MusicHandle) override {}
+    void stopMusic(MusicHandle) override {}
+
+    /// Set the held state of a key for the next frame(s)
+    inline void setKeyDown(Key key, bool down) { keys_[int(key)] = down; }
+
+    /// Last completed frame, GAME_WIDTH * GAME_HEIGHT pixels, row-major
+    const std::uint32_t* framebuffer() const { return frame_.data(); }
+
+    /// Upscale every completed frame with `filter` (see presented())
+    void setPresentFilter(UpscaleFilter filter, int nearestFactor);
+
+    /// Last completed frame as presented: upscaled once a present filter is
+    /// set, otherwise framebuffer()
+    const std::uint32_t* presented() const { return cpuPresent_ ? upscaler_.output() : frame_.data(); }
+    int presentedWidth() const  { return cpuPresent_ ? upscaler_.outputWidth()  : GAME_WIDTH; }
+    int presentedHeight() const { return cpuPresent_ ? upscaler_.outputHeight() : GAME_HEIGHT; }
+
+    /// Queue every completed native frame into `capture` (nullptr = stop)
+    void setCapture(FrameCapture *capture) { capture_ = capture; }
+
+    /// Write the presented frame as a binary PPM (P6)
+    bool savePpm(const std::string &path) const;
+
+    bool          closeRequested = false;
+    unsigned long frameLimit     = 0;
+    unsigned long drawCalls      = 0;  ///< since construction
+    unsigned long soundsPlayed   = 0;
+    unsigned long frames         = 0;
+
+private:
+    struct Surface {
+        int                        width  = 0;
+        int                        height = 0;
+        std::vector<std::uint32_t> pixels;
+    };
+
+    /// Surface behind a texture id, nullptr if unknown or unloaded
+    Surface* findSurface(unsigned int id);
+    TextureHandle addSurface(Surface surface);
+
+    std::vector<Surface>       surfaces_;      ///< texture id - 1
+    std::vector<std::uint32_t> frame_;
+    unsigned int               targetId_ = 0;  ///< render target being drawn into, 0 = frame_
+    bool                       cpuPresent_ = false;
+    Upscaler                   upscaler_;
+    FrameCapture              *capture_ = nullptr;
+    std::array<bool, KeyCount> keys_{};
+    std::array<bool, KeyCount> prevKeys_{};
+    int                        soundCount_ = 0;
+    int                        musicCount_ = 0;
+};
+
+#endif
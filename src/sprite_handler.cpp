@@ -1,8 +1,24 @@
 #include "sprite_handler.hpp"
 
-Sprite::Sprite(const std::string &filePath)
-  : texture_( LoadTexture(filePath.c_str()) )
+Sprite::Sprite(Platform &platform, const std::string &filePath)
+  : Sprite(platform, platform.loadTexture(filePath))
+{
+}
+
+Sprite::Sprite(Platform &platform, const TextureHandle &texture)
+  : platform_(&platform)
+  , texture_(texture)
 {
     // initialise the full‐texture rect
-    sourceRect_ = { 0, 0, float(texture_.width), float(texture_.height) };
+    region_ = { 0, 0, float(texture_.width), float(texture_.height) };
+    cutFrames();
+}
+
+Sprite::Sprite(Platform &platform, const TextureHandle &atlasPage, const Rect &region)
+  : platform_(&platform)
+  , texture_(atlasPage)
+  , region_(region)
+  , ownsTexture_(false)
+{
+    cutFrames();
 }
\ No newline at end of file
@@ -3,113 +3,126 @@
 #include <string>
 #include <vector>
 #include <array>
-#include <raylib.h>
 #include "settings.hpp"
+#include "platform_handler.hpp"
+
+//------------------------------------------------------------------------------
+// SpriteAnim: one entity's view of a sprite sheet – where it stands, which
+// way it faces and how far through the sheet's frames it is. Plain data,
+// owned by whoever draws it (Player, PlayState, ...), so any number of
+// entities can animate from the same Sprite independently.
+//------------------------------------------------------------------------------
+struct SpriteAnim {
+    int  x       = 0;
+    int  y       = 0;
+    int  frame   = 0;      ///< current frame index
+    int  timer   = 0;      ///< ticks since the last frame advance
+    int  speed   = 0;      ///< frame advances per second, 0 = the sheet's own
+    bool flipped = false;  ///< mirrored on the x-axis
+    bool paused  = false;  ///< keep ticking but hold the current frame
 
+    /// Jump back to the very first frame immediately
+    inline void reset() { frame = timer = 0; }
+};
+
+//------------------------------------------------------------------------------
+// Sprite: an immutable sprite sheet – a texture region cut into equally wide
+// frames, with every frame's source rect computed once. Drawing never
+// changes the sheet; the per-entity state lives in a SpriteAnim.
+//------------------------------------------------------------------------------
 class Sprite {
 public:
     // ----------------------------------------------------------------
     // life-cycle
-    explicit Sprite(const std::string &filePath);
-    ~Sprite()= default;// { UnloadTexture(texture_); }
+    Sprite(Platform &platform, const std::string &filePath);
+    /// Takes ownership of an already loaded texture
+    Sprite(Platform &platform, const TextureHandle &texture);
+    /// Sub-rectangle `region` of a shared atlas page (texture not owned)
+    Sprite(Platform &platform, const TextureHandle &atlasPage, const Rect &region);
+    ~Sprite()= default;// { platform_->unloadTexture(texture_); }
 
     // ----------------------------------------------------------------
     // rendering
-    void unload() { UnloadTexture(texture_); } // unloads the GPU texture
+    void unload() { if (ownsTexture_) platform_->unloadTexture(texture_); } // unloads the GPU texture
 
-    inline void draw() { // draw the current frame at position
-        DrawTextureRec(texture_, sourceRect_, { float(x), float(y) }, WHITE);
+    inline void draw(const SpriteAnim &anim) const { // draw an entity's current frame
+        drawFrame(anim.frame, anim.x, anim.y, anim.flipped);
     }
-    inline void drawFrame(int index) { // draw an expliict frame by index
-        sourceRect_.x = index * (texture_.width / frameCount_);
-        draw();
+    inline void drawFrame(int index, int x, int y, bool flipped = false) const { // draw an explicit frame
+        Rect src = frames_[size_t(index)];
+        if (flipped) src.width = -src.width;  // the backends mirror negative widths
+        platform_->drawTexture(texture_, src, float(x), float(y), layer);
     }
 
     // Animation control
-    /// Advances the frame timer, loops if needed, draws, and
+    /// Advances `anim`'s frame timer, loops if needed, draws, and
     /// returns true if we just wrapped around to frame 0.
-    inline bool updateAndDraw() { 
+    inline bool updateAndDraw(SpriteAnim &anim) const {
         bool last = false;
-        if (++frameTimer_ >= TARGET_FPS / ticksBwFrame_) {
-            frameTimer_ = 0;
-            if (!_isPaused) {
-                if (++currFrame_ >= frameCount_) {
-                    currFrame_ = 0;
+        if (++anim.timer >= TARGET_FPS / (anim.speed ? anim.speed : ticksBwFrame_)) {
+            anim.timer = 0;
+            if (!anim.paused) {
+                if (++anim.frame >= frameCount()) {
+                    anim.frame = 0;
                     last = true;
                 }
             }
-            sourceRect_.x = currFrame_ * (texture_.width / frameCount_);
         }
-        draw();
+        draw(anim);
         return last;
     }
     //how many sub-images (tiles) this texture is wrapped into
     inline void setFrameCount(int count) {
-        frameCount_      = count;
-        sourceRect_      = { 0, 0, float(texture_.width) / count, float(texture_.height) };
-        currFrame_   = 0;
-        frameTimer_  = 0;
+        frames_.resize(size_t(count));
+        cutFrames();
     }
 
-    // how many ticks to wait between frame advances
-    inline void setAnimationSpeed(int speed) { ticksBwFrame_ = speed; }
-
-    /// Jump back to the very first frame immediately
-    inline void resetAnimation()       { currFrame_ = frameTimer_ = 0; sourceRect_.x = 0; }
+    /// Point at a (re)loaded texture, or at {} once evicted, keeping the
+    /// frame count. Not owned (see EnemyResidency).
+    inline void setTexture(const TextureHandle &texture, const Rect &region) {
+        texture_     = texture;
+        region_      = region;
+        ownsTexture_ = false;
+        cutFrames();
+    }
 
-    // ----------------------------------------------------------------
-    // utilities
-    inline void invertHorizontally()          { sourceRect_.width = -sourceRect_.width; } // mirror on the x-axis
+    // default frame advances per second for entities animating this sheet
+    inline void setAnimationSpeed(int speed) { ticksBwFrame_ = speed; }
 
     // Accessors
-    inline Texture2D getTexture() const   { return texture_; }
-    inline int      getTileCount() const  { return frameCount_; }
+    inline TextureHandle getTexture() const { return texture_; }  // may be a shared atlas page
+    inline int      getWidth() const      { return int(region_.width); }  // whole sheet, all frames
+    inline int      getHeight() const     { return int(region_.height); }
+    inline int      getTileCount() const  { return frameCount(); }
 
-    // ----------------------------------------------------------------
-    // position & state
-    int x = 0, y = 0;
-    bool _isPaused = false;
+    DrawLayer layer = DrawLayer::Background;  ///< draw order within the frame
 
 private:
-    Texture2D texture_; //the GPU resident image
-    int       frameCount_     = 1; // how man ytiles horizontally
-    int       currFrame_  = 0;
-    int       frameTimer_ = 0; // tick counter for timing
-    Rectangle sourceRect_{}; // which slice of the texture to draw
+    Platform* platform_; // backend that owns the texture
+    TextureHandle texture_; //the GPU resident image (own file or atlas page)
+    Rect      region_{};    // where this sheet lives inside texture_
+    bool      ownsTexture_ = true;
+    std::vector<Rect> frames_ = std::vector<Rect>(1); // source rect of every frame
     int       ticksBwFrame_    = FRAME_SPEED; //
-};
 
-// List of all sprite asset names (without extension)
-inline const std::vector<std::string> spritesList = {
-    //logos and fonts
-    "game_name",    "logo_konami",  "font_symbols", 
-
-    //backgrounds/ icons
-    "bg_dojo", "life_icon",
-    
-    //HUD elements
-    "hud_health",    "green_health",  "red_health",
-
-    //player states
-    "player_default","player_crouch",  "player_punch_stand","player_kick_stand",
-    "player_punch_crouch", "player_kick_crouch","player_kick_high","player_kick_fly", "player_defeated", "player_smile",
-    
-    //enemy states
-    "wang_default", "wang_kick", "wang_punch", "wang_hit", "wang_defeated", //wang
-    "tao_default", "tao_kick",  "tao_punch", "tao_hit", "tao_defeated", //tao
-    "chen_default", "chen_kick", "chen_punch", "chen_hit", "chen_defeated", //chen
-    "lang_default", "lang_kick", "lang_punch", "lang_hit", "lang_defeated", //lang
-    "mu_default", "mu_kick", "mu_punch", "mu_hit", "mu_defeated", //mu
-    "spinning_chain","effect_hit"
+    inline int frameCount() const { return int(frames_.size()); }
+
+    /// Recompute frames_ from region_ (frames sit side by side)
+    inline void cutFrames() {
+        const int   step       = int(region_.width) / frameCount();
+        const float frameWidth = region_.width / frameCount();
+        for (int i = 0; i < frameCount(); i++)
+            frames_[size_t(i)] = { region_.x + i * step, region_.y, frameWidth, region_.height };
+    }
 };
 
 // On-screen text constants
-inline constexpr const char* COPYRIGHT_TEXT = "# 1985 konami";
-inline constexpr const char* OTHER_TEXT     = "# 2025 tanay";
-inline constexpr const char* TO_START_TEXT = "press enter to start";
+inline constexpr char COPYRIGHT_TEXT[] = "# 1985 konami";
+inline constexpr char OTHER_TEXT[]     = "# 2025 tanay";
+inline constexpr char TO_START_TEXT[]  = "press enter to start";
 
 // Characters supported for on-screen text
-inline const std::array<char, 36> spriteLetters = {
+inline constexpr std::array<char, 36> spriteLetters = {
     'a','b','c','d','e','f','g','h','i','k','l','m','n','o','p','q',
     'r','s','t','u','v','w','y','0','1','2','3','4','5','6','7','8','9','-',' ', '#'
 };
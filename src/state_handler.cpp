@@ -1,54 +1,79 @@
 #include "state_handler.hpp" 
+#include "profiler.hpp"
 #include <vector>
 #include <algorithm>
-#include <cstring>
 
 //------------------------------------------------------------------------------
-// file-local random helpers (only used inside this translation unit)
+// constant labels, translated to glyphs at compile time
 //------------------------------------------------------------------------------
 namespace {
-    // Returns a thread-local mersenne twister engine
-    std::mt19937& localRng() {
-      static thread_local std::mt19937 rng{std::random_device{}()};
-      return rng;
-    }
-  
-    int randBetween(int min, int max) {
-      std::uniform_int_distribution<int> dist(min, max);
-      return dist(localRng());
-    }
-  }
+    constexpr auto kCopyrightRun    = makeGlyphRun(COPYRIGHT_TEXT);
+    constexpr auto kOtherRun        = makeGlyphRun(OTHER_TEXT);
+    constexpr auto kToStartRun      = makeGlyphRun(TO_START_TEXT);
+    constexpr auto kControlsRun     = makeGlyphRun(" controls");
+    constexpr auto kLeftRun         = makeGlyphRun(" left - left arrow");
+    constexpr auto kRightRun        = makeGlyphRun(" right - right arrow");
+    constexpr auto kJumpRun         = makeGlyphRun(" jump - up arrow");
+    constexpr auto kCrouchRun       = makeGlyphRun(" crouch - down arrow");
+    constexpr auto kKickRun         = makeGlyphRun(" kick - s");
+    constexpr auto kPunchRun        = makeGlyphRun(" punch - a");
+    constexpr auto kQuitRun         = makeGlyphRun(" quit - escape");
+
+    constexpr auto kStageRun        = makeGlyphRun("stage 0");
+    constexpr auto kStageDashRun    = makeGlyphRun("stage-0");
+    constexpr auto kScoreRun        = makeGlyphRun("score");
+    constexpr auto kVersionLabelRun = makeGlyphRun("version");
+    constexpr auto kVersionRun      = makeGlyphRun(VERSION);
+    constexpr auto kPlayerRun       = makeGlyphRun("player");
+    constexpr auto kGameOverRun     = makeGlyphRun("game_over");
+    constexpr auto kYouWinRun       = makeGlyphRun("you win");
+    constexpr auto kYouLoseRun      = makeGlyphRun("you lose");
+}
 
   State::~State() {
-    // base cleanup: reset timers, free render texture
+    // base cleanup: reset timers
     cleanUp();
-    unloadTexture();
 }
 
 //------------------------------------------------------------------------------
 // State base class – ctor / dtor / main loop / cleanup
 //------------------------------------------------------------------------------
 State::State(Game *gm)
-: game_(gm), initialized_(false) {
+: game_(gm), initialized_(false), font_(gm->sprite(SpriteId::font_symbols)) {
     // One-time init, then input → draw → tick each frame
     cleanUp();
-    renderTexture_ = LoadRenderTexture(GAME_WIDTH, GAME_HEIGHT);
 }
 
 void State::run()
 {
+    PROFILE_ZONE("State::run");
     if (!initialized_) {
+        PROFILE_ZONE("State::init");
         init();
         initialized_ = true;
     }
-    handleInput();
-    draw();
-    timeTick();
+    {
+        PROFILE_ZONE("State::handleInput");
+        handleInput();
+    }
+    {
+        PROFILE_ZONE("State::draw");
+        draw();
+    }
+    {
+        PROFILE_ZONE("State::timeTick");
+        timeTick();
+    }
+}
+
+void State::beginFrame()
+{
+    game_->platform.beginFrame();
 }
 
-void State::unloadTexture()
+void State::endFrame()
 {
-    UnloadRenderTexture(renderTexture_);
+    game_->platform.endFrame();
 }
 
 void State::cleanUp()
@@ -59,169 +84,144 @@ void State::cleanUp()
     
 }
 
+void State::captureBase(StateSnapshot &out) const
+{
+    out.frameCounter   = frameCounter_;
+    out.elapsedSeconds = elapsedSeconds_;
+    out.initialized    = initialized_;
+    out.reserved[0] = out.reserved[1] = out.reserved[2] = 0;
+}
+
+void State::restoreBase(const StateSnapshot &in)
+{
+    frameCounter_   = in.frameCounter;
+    elapsedSeconds_ = in.elapsedSeconds;
+    initialized_    = in.initialized != 0;
+}
+
 //------------------------------------------------------------------------------
-// drawText: render a blinking ASCII string via your sprite font
+// drawText: render an ASCII string via the sprite font (see font_handler.hpp)
 //------------------------------------------------------------------------------
-void State::drawText(const string &text, int x, int y, bool blink)
-{
-    // initialize blink timers on first use
-    if (!_currFrame.count(text)) {
-        _currFrame[text]   = 0;
-        _frameTimer[text]  = 0;
-    }
-
-    // advance blink counter if requested
-    if (blink) {
-        auto &t = _frameTimer[text];
-        if (++t >= TARGET_FPS/FRAME_SPEED) {
-            t = 0;
-            if (++_currFrame[text] > 1) {
-                _currFrame[text] = 0;
-                onBlinkingComplete();
-            }
-        }
-    }
-    
-    int blankIdx = spriteLetters.size() - 2;
-
-    // draw each character
-    for (char ch : text) {
-        // find its frame in the sheet
-        auto it = find(spriteLetters.begin(), spriteLetters.end(), ch);
-        if (it == spriteLetters.end()) {
-            x += FontCharWidth;// unknown glyph → skip
-            continue;
-        }
-        int idx = distance(spriteLetters.begin(), it);
+bool State::blinkHidden(TextBlink *blink)
+{
+    if (blink == nullptr) return false;
 
-        // point our sprite at the right place on screen
-        auto &font = game_->sprites.at("font_symbols");
-        font.x = x;
-        font.y = y;
+    // advance blink counter; a full off→on cycle notifies the state
+    if (blink->tick())
+        onBlinkingComplete();
+    return !blink->visible();
+}
 
-        // blink logic: blank vs real
-       if (blink &&  _currFrame[text] != 1){
-            font.drawFrame(blankIdx);
-        }
-       else {
-            font.drawFrame(idx);
-       }
-        x += FontCharWidth;
-    }
+void State::drawText(std::string_view text, int x, int y, TextBlink *blink)
+{
+    font_.drawText(text, x, y, blinkHidden(blink));
 }
 
 //------------------------------------------------------------------------------
-// IntroState: title screen
+// Static layer: composed into a render target once, then one draw per frame
 //------------------------------------------------------------------------------
-void IntroState::init()
+void State::drawCachedStatic(int key)
 {
-    // set konami logo to center
-    auto &logoSprite= game_->sprites.at("logo_konami");
-    logoSprite.x = (GAME_WIDTH / 2) - (game_->sprites.at("logo_konami").getTexture().width / 2);
-    logoSprite.y = 30;
-    
-    // set game_name to center
-    auto &gameNameSprite= game_->sprites.at("game_name");
-    gameNameSprite.x = (GAME_WIDTH / 2) - (game_->sprites.at("game_name").getTexture().width / 2);
-    gameNameSprite.y = 75;
+    Platform &platform = game_->platform;
+    if (staticLayer_.id == 0)
+    {
+        staticLayer_ = platform.createRenderTarget(GAME_WIDTH, GAME_HEIGHT);
+        staticKey_   = -1;
+        if (staticLayer_.id == 0) { drawStaticLayer(); return; } // no render targets
+    }
+
+    if (key != staticKey_)
+    {
+        platform.beginRenderTarget(staticLayer_);
+        drawStaticLayer();
+        platform.endRenderTarget();
+        staticKey_ = key;
+    }
+    platform.drawTexture(staticLayer_, { 0, 0, float(GAME_WIDTH), float(GAME_HEIGHT) },
+                         0, 0, DrawLayer::Background);
 }
 
+void State::releaseRenderTargets()
+{
+    if (staticLayer_.id != 0) game_->platform.unloadTexture(staticLayer_);
+    staticKey_ = -1;
+}
+
+void PlayState::releaseRenderTargets()
+{
+    hud_.release(game_->platform);
+    particles.release(game_->platform);
+    State::releaseRenderTargets();
+}
+
+//------------------------------------------------------------------------------
+// IntroState: title screen
+//------------------------------------------------------------------------------
+void IntroState::init() {}  // logo and title are placed by drawStaticLayer
+
 void IntroState::handleInput()
 {
     // Wait for ENTER to start blinking, then allow proceed
-    if (IsKeyReleased(KEY_ENTER))
+    if (game_->platform.isKeyReleased(Key::Enter))
     {
         canProceed = true;
     }
-    else if(IsKeyDown(KEY_ENTER) && canProceed && !blinkEnter_)
+    else if(game_->platform.isKeyDown(Key::Enter) && canProceed && !blinkEnter_)
     {
         blinkEnter_ = true;
-        PlayMusicStream(game_->musics.at("main_music"));
+        game_->platform.playMusic(game_->music(MusicId::main_music));
     }
 }
 
 void IntroState::drawStage()
 {
-    // Draw Konami logo and game title
-    game_->sprites.at("logo_konami").draw();
-    game_->sprites.at("game_name").draw();
-
-    // Copyright & “other” text
-    drawText(COPYRIGHT_TEXT,
-             (GAME_WIDTH/2) - ((std::strlen(COPYRIGHT_TEXT) * FontCharWidth)/2),
-             98,
-             false);
-    drawText(OTHER_TEXT,
-             centerText(std::strlen(OTHER_TEXT)),
-             108,
-             false);
+    // Logos, copyright and controls never change
+    drawCachedStatic(0);
 
     // “Press Enter to begin” blinking prompt
-    drawText(TO_START_TEXT,
-             centerText(std::strlen(TO_START_TEXT)),
-             118,
-             blinkEnter_);
-
-
-    const char* controlsTitle = " controls";
-    drawText(controlsTitle,
-             centerText(std::strlen(controlsTitle)),
-             130,
-             false);
-
-    drawText(" left - left arrow",
-             centerText(std::strlen(" left - left arrow")),
-             145,
-             false);
-
-    drawText(" right - right arrow",
-             centerText(std::strlen(" right - right arrow")),
-             166,
-             false);
-
-    drawText(" jump - up arrow",
-             centerText(std::strlen(" jump - up arrow")),
-             182,
-             false);
-
-    drawText(" crouch - down arrow",
-             centerText(std::strlen(" crouch - down arrow")),
-             198,
-             false);
-
-    drawText(" kick - s",
-             centerText(std::strlen(" kick - s")),
-             214,
-             false);
-
-    drawText(" punch - a",
-             centerText(std::strlen(" punch - a")),
-             225,
-             false);
-
-    drawText(" quit - escape",
-             centerText(std::strlen(" quit - escape")),
-             245,
-             false);
+    drawText(kToStartRun, centerText(kToStartRun.size()), 118,
+             blinkEnter_ ? &enterBlink_ : nullptr);
 
     // Continue streaming background music
-    UpdateMusicStream(game_->musics.at("main_music"));
+    game_->platform.updateMusic(game_->music(MusicId::main_music));
+}
+
+void IntroState::drawStaticLayer()
+{
+    // Draw Konami logo and game title, centered
+    const Sprite &logo = game_->sprite(SpriteId::logo_konami);
+    const Sprite &name = game_->sprite(SpriteId::game_name);
+    logo.drawFrame(0, (GAME_WIDTH / 2) - (logo.getWidth() / 2), 30);
+    name.drawFrame(0, (GAME_WIDTH / 2) - (name.getWidth() / 2), 75);
+
+    // Copyright & “other” text
+    drawText(kCopyrightRun, centerText(kCopyrightRun.size()), 98);
+    drawText(kOtherRun,     centerText(kOtherRun.size()),     108);
+
+    drawText(kControlsRun, centerText(kControlsRun.size()), 130);
+    drawText(kLeftRun,     centerText(kLeftRun.size()),     145);
+    drawText(kRightRun,    centerText(kRightRun.size()),    166);
+    drawText(kJumpRun,     centerText(kJumpRun.size()),     182);
+    drawText(kCrouchRun,   centerText(kCrouchRun.size()),   198);
+    drawText(kKickRun,     centerText(kKickRun.size()),     214);
+    drawText(kPunchRun,    centerText(kPunchRun.size()),    225);
+    drawText(kQuitRun,     centerText(kQuitRun.size()),     245);
 }
 
 
 /*void IntroState::drawStage()
 {
-    game_->sprites.at("logo_konami").draw();
-    game_->sprites.at("game_name").draw();
+    game_->sprite(SpriteId::logo_konami).draw();
+    game_->sprite(SpriteId::game_name).draw();
 
     //draw copyright mark
-    drawText(COPYRIGHT_TEXT, (GAME_WIDTH / 2) - ((std::strlen(COPYRIGHT_TEXT) * FontCharWidth) / 2), 95, false);
-    drawText(OTHER_TEXT, centerText(strlen(OTHER_TEXT)), 105, false);
+    drawText(kCopyrightRun, centerText(kCopyrightRun.size()), 95);
+    drawText(kOtherRun, centerText(kOtherRun.size()), 105);
 
     // press enter to begin
-    drawText(TO_START_TEXT, centerText(strlen(TO_START_TEXT)), 155, blinkEnter_);
+    drawText(kToStartRun, centerText(kToStartRun.size()), 155, blinkEnter_ ? &enterBlink_ : nullptr);
 
-    UpdateMusicStream(game_->musics.at("main_music"));
+    game_->platform.updateMusic(game_->music(MusicId::main_music));
 }*/
 
 void IntroState::onBlinkingComplete()
@@ -239,23 +239,49 @@ void IntroState::onBlinkingComplete()
 void IntroState::cleanUp()
 {
     blinkCount_ = 0; blinkEnter_ = false;
+    enterBlink_.reset();
     State::cleanUp();
 }
 
 void IntroState::onTimeTick(){}
 
+void IntroState::capture(IntroSnapshot &out) const
+{
+    captureBase(out.base);
+    out.blinkFrameTimer = enterBlink_.frameTimer;
+    out.blinkCurrFrame  = enterBlink_.currFrame;
+    out.blinkCount      = blinkCount_;
+    out.blinkEnter      = blinkEnter_;
+    out.canProceed      = canProceed;
+    out.reserved[0] = out.reserved[1] = 0;
+}
+
+void IntroState::restore(const IntroSnapshot &in)
+{
+    restoreBase(in.base);
+    enterBlink_.frameTimer = in.blinkFrameTimer;
+    enterBlink_.currFrame  = in.blinkCurrFrame;
+    blinkCount_            = in.blinkCount;
+    blinkEnter_            = in.blinkEnter != 0;
+    canProceed             = in.canProceed != 0;
+}
+
 //------------------------------------------------------------------------------
 // PreviewState: “Get ready” screen before PlayState
 //------------------------------------------------------------------------------
+void PreviewState::init()
+{
+    // swap enemy textures while the stage card is up (next one in background);
+    // not ahead of time, the level being left is still drawn until then
+    if (!game_->outputMuted(Mute::Persistent))
+        game_->residency.enterLevel(game_->level);
+}
+
 void PreviewState::drawStage()
 {
-    UpdateMusicStream(game_->musics.at("main_music"));
-    drawText(
-        "stage 0" + to_string(game_->level), 
-        centerText(8),
-       centerText(1),
-        false
-    );
+    game_->platform.updateMusic(game_->music(MusicId::main_music));
+    drawText(kStageRun, centerText(8), centerText(1));
+    drawNumber(game_->level, centerText(8) + kStageRun.size() * FontCharWidth, centerText(1));
 }
 
 
@@ -270,26 +296,32 @@ void PreviewState::cleanUp() {
     State::cleanUp();
 }
 
+void PreviewState::capture(PreviewSnapshot &out) const { captureBase(out.base); }
+void PreviewState::restore(const PreviewSnapshot &in)  { restoreBase(in.base); }
+
 //------------------------------------------------------------------------------
 // PlayState: actual gameplay state
 //------------------------------------------------------------------------------
-void PlayState::init()
+PlayState::PlayState(Game *gm)
+: State(gm)
 {
-    game_->sprites.at("life_icon").y = 45;
-
-    game_->sprites.at("hud_health").y = 205;
-    game_->sprites.at("hud_health").x = (GAME_WIDTH / 2) - (game_->sprites.at("hud_health").getTexture().width / 2);
-
-    game_->sprites.at("green_health").y = 208;
-    game_->sprites.at("red_health").y = 208;
-
-    game_->sprites.at("spinning_chain").setAnimationSpeed(SpinningChainSpriteFPS);
+    // retained HUD, bound to the values it shows (see hud_handler.hpp)
+    Sprite &green = game_->sprite(SpriteId::green_health);
+    Sprite &red   = game_->sprite(SpriteId::red_health);
+    hud_.addCounter(game_->score, font_, 22, 46);
+    hud_.addIconRow(game_->player->lives, game_->sprite(SpriteId::life_icon), 165, 45, 8);
+    hud_.addGauge(game_->player->health, green, red, LOW_HEALTH, 104, 208, -8);
+    hud_.addGauge(enemyHealth,           green, red, LOW_HEALTH, 144, 208, 8);
+}
 
+void PlayState::init()
+{
     reset();
 }
 
 void PlayState::run()
 {
+    PROFILE_ZONE("PlayState::run");
     State::run();
     if (!pauseMovement)
     {
@@ -307,7 +339,7 @@ void PlayState::handleInput()
         game_->player->handleInput();
 
     // Restart on ENTER after game over    
-    if (((game_->playState->enemyEndState == EnemyEndSequence::GameOver) || (game_->playState->endState == EndSequence::GameOver)) && IsKeyDown(KEY_ENTER))
+    if (((game_->playState->enemyEndState == EnemyEndSequence::GameOver) || (game_->playState->endState == EndSequence::GameOver)) && game_->platform.isKeyDown(Key::Enter))
     {
         cleanUp();
         game_->state = GameState::Intro;
@@ -319,83 +351,68 @@ void PlayState::handleInput()
 
 void PlayState::drawStage()
 {
+    PROFILE_ZONE("PlayState::drawStage");
     // draw background, HUD, text labels, health bars, sprites, etc.
-    UpdateMusicStream(game_->musics.at("main_music"));
+    game_->platform.updateMusic(game_->music(MusicId::main_music));
 
-    // background is the last to draw
-    game_->sprites.at("bg_dojo").draw();
+    // background, labels and health bar frame: composed once per level
+    drawCachedStatic(game_->level);
 
-    drawText(OTHER_TEXT, centerText(strlen(OTHER_TEXT)), 24, false);
+    // score, lives and health gauges: one cached surface, redrawn on change
+    hud_.draw(game_->platform);
 
-    drawText(
-        "stage-0" + to_string(game_->level), 
-        165, 
-        38, 
-        false
-    );
+    // show enemy
+    renderEnemy();
 
-    drawText("score", 22, 38, false);
-    drawText(to_string(game_->score), 22, 46, false);
+    // show player
+    game_->player->play();
 
-    drawText("version", centerText(7), 38, false);
-    drawText(VERSION, centerText(5), 46, false);
+    // hit sparks fly over both fighters (cosmetic: they move with the ticks
+    // that are heard, not again in a rollback or ahead of time)
+    if (!game_->outputMuted(Mute::Sounds)) particles.update();
+    particles.draw(game_->platform);
 
-    game_->sprites.at("life_icon").x = 165;
-    for (int x = 0; x < game_->player->lives; x++)
+    if (renderEnemyHit)
     {
-        game_->sprites.at("life_icon").draw();
-        game_->sprites.at("life_icon").x += 8;
+        enemyAnim(EnemyPose::Hit).flipped = isEnemyFlipped;
+        enemySprite(EnemyPose::Hit).draw(enemyAnim(EnemyPose::Hit));
     }
 
-     // HUD + health bars, collision, rendering, etc.
-    drawText("player", 46, (GAME_HEIGHT - 24), false);
-    drawText(enemies[game_->level - 1], (208 - (enemies[game_->level - 1].size() * 8)), (GAME_HEIGHT - 24), false);
-
-    game_->sprites.at("hud_health").draw();
 
-    game_->sprites.at("green_health").x = 104;
-    game_->sprites.at("red_health").x = 104;
-
-    //draw player's health gauge
-    for (int x = 0; x < game_->player->health; x++)
+    if (game_->playState->endState == EndSequence::GameOver || game_->playState->enemyEndState == EnemyEndSequence::GameOver)
     {
-        string h_hud = (game_->player->health > LOW_HEALTH)? "green" : "red";
-        game_->sprites.at(h_hud+ "_health").draw();
-        game_->sprites.at(h_hud+ "_health").x -= 8;
-    }
-
-    //draw health gauge
-    game_->sprites.at("green_health").x = 144;
-    game_->sprites.at("red_health").x = 144;
+        drawText(kGameOverRun, centerText(kGameOverRun.size()), centerText(1));
 
-    for (int x = 0; x < enemyHealth; x++)
-    {
-        string h_hud = (enemyHealth > LOW_HEALTH)? "green" : "red";
-        game_->sprites.at(h_hud+ "_health").draw();
-        game_->sprites.at(h_hud + "_health").x += 8;
+        if (game_->playState->endState == EndSequence::GameOver)
+            drawText(kYouWinRun, centerText(kYouWinRun.size()), centerText(1)+8);
+        else
+            drawText(kYouLoseRun, centerText(kYouLoseRun.size()), centerText(1)+8);
     }
+}
 
-    // show enemy
-    renderEnemy();
+void PlayState::drawStaticLayer()
+{
+    // background is the last to draw
+    if (game_->stageTiles.isReady())
+        game_->stageTiles.draw(game_->platform, 0, 0, DrawLayer::Background);
+    else
+        game_->sprite(SpriteId::bg_dojo).drawFrame(0, 0, 0);
 
-    // show player
-    game_->player->play();
+    drawText(kOtherRun, centerText(kOtherRun.size()), 24);
 
-    if (renderEnemyHit)
-        game_->sprites.at(enemies[game_->level - 1] + "_hit").draw();
+    drawText(kStageDashRun, 165, 38);
+    drawNumber(game_->level, 165 + kStageDashRun.size() * FontCharWidth, 38);
 
+    drawText(kScoreRun, 22, 38);
 
-    if (game_->playState->endState == EndSequence::GameOver || game_->playState->enemyEndState == EnemyEndSequence::GameOver)
-    {
-        drawText("game_over", centerText(9), centerText(1), false);
+    drawText(kVersionLabelRun, centerText(kVersionLabelRun.size()), 38);
+    drawText(kVersionRun, centerText(kVersionRun.size()), 46);
 
-        drawText(
-            (game_->playState->endState == EndSequence::GameOver )? "you win": "you lose", 
-            ((game_->playState->endState == EndSequence::GameOver )? centerText(7): centerText(8)),
-            centerText(1)+8,
-            false
-        );
-    }
+    drawText(kPlayerRun, 46, (GAME_HEIGHT - 24));
+    drawText(enemies[game_->level - 1], (208 - (enemies[game_->level - 1].size() * 8)), (GAME_HEIGHT - 24));
+
+    const Sprite &healthFrame = game_->sprite(SpriteId::hud_health);
+    healthFrame.drawFrame(0, (GAME_WIDTH / 2) - (healthFrame.getWidth() / 2), 205);
 }
 
 void PlayState::tickEnemyMovement()
@@ -419,13 +436,31 @@ void PlayState::enemyPursuePlayer()
 void PlayState::enemyBasicAttack()
 {
     enemyMoveState = MoveState::ChargeAttack;
-    enemyRandomAttack = randBetween(0, 1);
+    enemyRandomAttack = game_->randBetween(0, 1);
     enemyCurrentMove = attackList[enemyRandomAttack];
 }
 
+void PlayState::enemyFollowInput()
+{
+    const InputSnapshot &input = game_->enemyInput;
+    if (input.down(Key::A) || input.down(Key::S))
+    {
+        enemyMoveState    = MoveState::ChargeAttack;
+        enemyRandomAttack = input.down(Key::S) ? 0 : 1;   // index into attackList: kick, punch
+        enemyCurrentMove  = attackList[enemyRandomAttack];
+        return;
+    }
+
+    const int rightLimit = GAME_WIDTH - StageBoundary - game_->sprite(SpriteId::player_default).getWidth() / 2;
+    if (input.down(Key::Left) && enemyX > StageBoundary)
+        offsetEnemyX(EnemyWalkSpeed, false);
+    if (input.down(Key::Right) && enemyX < rightLimit)
+        offsetEnemyX(EnemyWalkSpeed, true);
+}
+
 bool PlayState::playerInRange()
 {
-    int boundary = (game_->sprites.at("player_default").getTexture().width / game_->sprites.at("player_default").getTileCount()) + 10;
+    int boundary = (game_->sprite(SpriteId::player_default).getWidth() / game_->sprite(SpriteId::player_default).getTileCount()) + 10;
 
     return (enemyX >= game_->player->x - boundary
             && isEnemyFlipped)
@@ -446,14 +481,12 @@ void PlayState::moveEnemyRight(bool goingRight) {
     const int leftLimit  = StageBoundary + EnemyRunBoundary;
     const int rightLimit = GAME_WIDTH 
         - (StageBoundary + EnemyRunBoundary)
-        - (game_->sprites.at("player_default").getTexture().width / 2);
+        - (game_->sprite(SpriteId::player_default).getWidth() / 2);
 
     if (runCounter > EnemyRetreatDistance) {
         // when done backing off, go back to follow and reset speed
         enemyMoveState = MoveState::FollowPlayer;
-        game_->sprites
-            .at(enemies[game_->level - 1] + "_default")
-            .setAnimationSpeed(EnemyWalkSpriteFPS);
+        enemyAnim(EnemyPose::Default).speed = EnemyWalkSpriteFPS;
     }
     if ((goingRight && enemyX < rightLimit) ||
              (!goingRight && enemyX > leftLimit)) {
@@ -484,6 +517,11 @@ void PlayState::updateEnemyMovementState()
             moveEnemyRight(true);
             break;
         default:
+            if (game_->versus)
+            {
+                enemyFollowInput();
+                break;
+            }
             enemyPursuePlayer();
 
             if (playerInRange())
@@ -495,6 +533,61 @@ void PlayState::updateEnemyMovementState()
     }
 }
 
+void PlayState::capture(PlaySnapshot &out) const
+{
+    captureBase(out.base);
+    out.enemyHealth       = enemyHealth;
+    out.enemyX            = enemyX;
+    out.enemyY            = enemyY;
+    out.enemyCurrentMove  = std::int32_t(enemyCurrentMove);
+    out.enemyRandomAttack = enemyRandomAttack;
+    out.enemyMoveState    = std::int32_t(enemyMoveState);
+    out.endState          = std::int32_t(endState);
+    out.enemyEndState     = std::int32_t(enemyEndState);
+    out.retreatCounter    = retreatCounter;
+    out.runCounter        = runCounter;
+    out.haltTime          = haltTime;
+    out.haltTimeHit       = haltTimeHit;
+    out.maxHaltTime       = maxHaltTime;
+    out.rotatingChainX    = rotatingChainX;
+    out.rotatingChainY    = rotatingChainY;
+    out.isEnemyFlipped    = isEnemyFlipped;
+    out.pauseMovement     = pauseMovement;
+    out.renderEnemyHit    = renderEnemyHit;
+    out.reserved          = 0;
+    for (size_t e = 0; e < EnemyCount; e++)
+        for (size_t p = 0; p < EnemyPoseCount; p++)
+            out.enemyAnims[e][p] = toSnapshot(enemyAnims_[e][p]);
+    out.chainAnim = toSnapshot(chainAnim_);
+}
+
+void PlayState::restore(const PlaySnapshot &in)
+{
+    restoreBase(in.base);
+    enemyHealth       = in.enemyHealth;
+    enemyX            = in.enemyX;
+    enemyY            = in.enemyY;
+    enemyCurrentMove  = EnemyAction(in.enemyCurrentMove);
+    enemyRandomAttack = in.enemyRandomAttack;
+    enemyMoveState    = MoveState(in.enemyMoveState);
+    endState          = EndSequence(in.endState);
+    enemyEndState     = EnemyEndSequence(in.enemyEndState);
+    retreatCounter    = in.retreatCounter;
+    runCounter        = in.runCounter;
+    haltTime          = in.haltTime;
+    haltTimeHit       = in.haltTimeHit;
+    maxHaltTime       = in.maxHaltTime;
+    rotatingChainX    = in.rotatingChainX;
+    rotatingChainY    = in.rotatingChainY;
+    isEnemyFlipped    = in.isEnemyFlipped != 0;
+    pauseMovement     = in.pauseMovement != 0;
+    renderEnemyHit    = in.renderEnemyHit != 0;
+    for (size_t e = 0; e < EnemyCount; e++)
+        for (size_t p = 0; p < EnemyPoseCount; p++)
+            enemyAnims_[e][p] = fromSnapshot(in.enemyAnims[e][p]);
+    chainAnim_ = fromSnapshot(in.chainAnim);
+}
+
 void PlayState::onBlinkingComplete(){}
 
 void PlayState::cleanUp()     { reset(); game_->player->clear(); State::cleanUp(); }
@@ -521,7 +614,7 @@ void PlayState::onTimeTick()
             enemyHealth -= 1;
             if (enemyHealth == 0)
             {
-                StopMusicStream(game_->musics.at("main_music"));
+                game_->platform.stopMusic(game_->music(MusicId::main_music));
                 haltTime = 0;
             }
             else
@@ -530,7 +623,7 @@ void PlayState::onTimeTick()
                 {
                     runCounter = 0;
                     enemyMoveState = (!isEnemyFlipped)? MoveState::RetreatRunningRight : MoveState::RetreatRunningLeft;
-                    game_->sprites.at(enemies[game_->level - 1] + "_default").setAnimationSpeed(EnemyRunSpriteFPS);   
+                    enemyAnim(EnemyPose::Default).speed = EnemyRunSpriteFPS;
                 }
             }
         }
@@ -569,9 +662,9 @@ void PlayState::onTimeTick()
             game_->player->isShaking = false;
 
             if (
-                (game_->player->currAction_ == PlayerAction::WalkRight && !IsKeyDown(KEY_RIGHT))
-                || (game_->player->currAction_ == PlayerAction::WalkLeft && !IsKeyDown(KEY_LEFT))
-                || (game_->player->currAction_ == PlayerAction::Crouch && !IsKeyDown(KEY_DOWN))
+                (game_->player->currAction_ == PlayerAction::WalkRight && !game_->platform.isKeyDown(Key::Right))
+                || (game_->player->currAction_ == PlayerAction::WalkLeft && !game_->platform.isKeyDown(Key::Left))
+                || (game_->player->currAction_ == PlayerAction::Crouch && !game_->platform.isKeyDown(Key::Down))
             )
             {
                 game_->player->setMovement(0);
@@ -592,8 +685,7 @@ void PlayState::processEnemyEndState()
         case EnemyEndSequence::LieDown:
             game_->player->setMovement(13);
             game_->player->y = kPlayerDefaultY;
-            game_->sprites.at("player_defeated").resetAnimation();
-            PlaySound(game_->sounds.at("defeated"));
+            game_->platform.playSound(game_->sound(SoundId::defeated));
             enemyEndState = EnemyEndSequence::MoveFeet;
             break;
         case EnemyEndSequence::MoveFeet:
@@ -605,18 +697,18 @@ void PlayState::processEnemyEndState()
             {
                 game_->player->lives --;
                 game_->state = GameState::Preview;
-                PlayMusicStream(game_->musics.at("main_music"));
+                game_->platform.playMusic(game_->music(MusicId::main_music));
                 cleanUp();
                 return;
             }
-            PlaySound(game_->sounds.at("game_over"));
+            game_->platform.playSound(game_->sound(SoundId::game_over));
             enemyEndState = EnemyEndSequence::GameOver;
             break;
         default:
             // END_STATE_ENEMY_START
             enemyEndState = EnemyEndSequence::LieDown;
             enemyCurrentMove = EnemyAction::Pause;
-            StopMusicStream(game_->musics.at("main_music"));
+            game_->platform.stopMusic(game_->music(MusicId::main_music));
             game_->player->life_counter = 0;
             break;
     }
@@ -628,7 +720,7 @@ void PlayState::processEndState()
     switch(endState)
     {
         case EndSequence::PlayWinSound:
-            PlaySound(game_->sounds.at("win"));
+            game_->platform.playSound(game_->sound(SoundId::win));
             endState = EndSequence::ShowPunch;
             break;
         case EndSequence::ShowPunch:
@@ -657,7 +749,7 @@ void PlayState::processEndState()
             if (game_->player->health > 0)
             {
                 game_->player->health -= 1;
-                PlaySound(game_->sounds.at("counting"));
+                game_->platform.playSound(game_->sound(SoundId::counting));
                 game_->score += 100;
                 return;
             }
@@ -667,21 +759,21 @@ void PlayState::processEndState()
             maxHaltTime = EndDelayHigh;
             if (game_->level == 5)
             {
-                PlaySound(game_->sounds.at("game_over"));
+                game_->platform.playSound(game_->sound(SoundId::game_over));
                 endState = EndSequence::GameOver;
                 return;
             }
             cleanUp();
             game_->level ++;
             game_->state = GameState::Preview;
-            PlayMusicStream(game_->musics.at("main_music"));
+            game_->platform.playMusic(game_->music(MusicId::main_music));
             break;
         case EndSequence::GameOver:
             break;
         default:
             // END_STATE_START
             enemyCurrentMove = EnemyAction::Defeated;
-            PlaySound(game_->sounds.at("defeated"));
+            game_->platform.playSound(game_->sound(SoundId::defeated));
             endState = EndSequence::PlayWinSound;
             break;
     }
@@ -690,10 +782,10 @@ void PlayState::processEndState()
 void PlayState::prepareEndOfRoundChoreography(int pMove, bool flip, bool playSound)
 {
     if (flip)
-        game_->player->invertSprites();
+        game_->player->flip();
     game_->player->setMovement(pMove);
     if (playSound)
-        PlaySound(game_->sounds.at("attack"));
+        game_->platform.playSound(game_->sound(SoundId::attack));
     
     // Advance to the next state, without wrapping past GameOver:
     if (endState != EndSequence::GameOver) {
@@ -703,15 +795,23 @@ void PlayState::prepareEndOfRoundChoreography(int pMove, bool flip, bool playSou
     }
 }
 
-void PlayState::updateEnemySpritePositions()
+Sprite& PlayState::enemySprite(EnemyPose pose)
+{
+    return game_->sprite(enemySpriteTable[game_->level - 1][size_t(pose)]);
+}
+
+SpriteAnim& PlayState::enemyAnim(EnemyPose pose)
 {
-    const string& id = enemies[game_->level - 1];
-    for(int x = 0; x < enemySprites.size() ; x++)
+    return enemyAnims_[game_->level - 1][size_t(pose)];
+}
+
+void PlayState::updateEnemyAnimPositions()
+{
+    for (EnemyPose pose : { EnemyPose::Default, EnemyPose::Defeated })
     {
-        if (enemySprites[x] == "hit" || enemySprites[x] == "punch" || enemySprites[x] == "kick")
-            continue;
-        game_->sprites.at(id + "_" + enemySprites[x]).x = enemyX;
-        game_->sprites.at(id + "_" + enemySprites[x]).y = enemyY;
+        enemyAnim(pose).x = enemyX;
+        enemyAnim(pose).y = enemyY;
+        enemyAnim(pose).flipped = isEnemyFlipped;
     }
 }
 
@@ -756,8 +856,8 @@ bool PlayState::isCollidedWithPlayer()
         return false;
     }
     // collision
-    game_->sprites.at(enemies[game_->level - 1] + "_hit").x = outX;
-    game_->sprites.at(enemies[game_->level - 1] + "_hit").y = outY;
+    enemyAnim(EnemyPose::Hit).x = outX;
+    enemyAnim(EnemyPose::Hit).y = outY;
     return true;
 }
 
@@ -765,14 +865,14 @@ void PlayState::resetEnemyMove()
 {
     enemyCurrentMove = EnemyAction::Idle;
     enemyMoveState = MoveState::FollowPlayer;
-    game_->sprites.at(enemies[game_->level - 1] + "_" + enemySprites[enemyRandomAttack]).resetAnimation();
+    enemyAnim(EnemyPose(enemyRandomAttack)).reset();
 }
 
 void PlayState::processCollisionWithPlayer()
 {
     enemyCurrentMove = EnemyAction::Pause;
     renderEnemyHit = true;
-    PlaySound(game_->sounds.at("collision2"));
+    game_->platform.playSound(game_->sound(SoundId::collision2));
     haltTimeHit = 0;
 
     game_->player->oldX = game_->player->x;
@@ -780,9 +880,14 @@ void PlayState::processCollisionWithPlayer()
 
     game_->player->health --;
 
+    // sparks fly the way the enemy hit
+    const SpriteAnim &hit = enemyAnim(EnemyPose::Hit);
+    if (!game_->outputMuted(Mute::Sounds))
+        particles.burst(float(hit.x), float(hit.y), HIT_SPARKS, isEnemyFlipped ? 1 : -1);
+
     if (game_->player->health == LOW_HEALTH)
     {
-        PlaySound(game_->sounds.at("health_low"));
+        game_->platform.playSound(game_->sound(SoundId::health_low));
     }
 
     if (!isEnemyFlipped)
@@ -795,22 +900,26 @@ void PlayState::processCollisionWithPlayer()
 
 void PlayState::renderEnemy()
 {
-    updateEnemySpritePositions();
+    PROFILE_ZONE("PlayState::renderEnemy");
+    updateEnemyAnimPositions();
 
     switch(enemyCurrentMove)
     {
         case EnemyAction::MoveLeft:
             break;
         case EnemyAction::Defeated:
-            game_->sprites.at(enemies[game_->level - 1] + "_defeated").draw();
+            enemySprite(EnemyPose::Defeated).draw(enemyAnim(EnemyPose::Defeated));
             break;
         case EnemyAction::Kick:
         case EnemyAction::Punch:
-            game_->sprites.at(enemies[game_->level - 1] + "_" + enemySprites[enemyRandomAttack]).y = enemyY;
-            game_->sprites.at(enemies[game_->level - 1] + "_" + enemySprites[enemyRandomAttack]).x = enemyX - enemyBodyHitBoxes[game_->level - 1].kickAdjustment;
-            game_->sprites.at(enemies[game_->level - 1] + "_" + enemySprites[enemyRandomAttack])._isPaused = game_->player->showHit_;
+        {
+            SpriteAnim &attack = enemyAnim(EnemyPose(enemyRandomAttack));
+            attack.y = enemyY;
+            attack.x = enemyX - enemyBodyHitBoxes[game_->level - 1].kickAdjustment;
+            attack.flipped = isEnemyFlipped;
+            attack.paused = game_->player->showHit_;
             
-            if (game_->sprites.at(enemies[game_->level - 1] + "_" + enemySprites[enemyRandomAttack]).updateAndDraw()) // if last frame
+            if (enemySprite(EnemyPose(enemyRandomAttack)).updateAndDraw(attack)) // if last frame
             {
                 if (!isCollidedWithPlayer())
                 {
@@ -823,22 +932,26 @@ void PlayState::renderEnemy()
                 }
             }
             break;
+        }
         case EnemyAction::Pause:
-            game_->sprites.at(enemies[game_->level - 1] + "_" + enemySprites[enemyRandomAttack]).drawFrame(1);
+        {
+            const SpriteAnim &attack = enemyAnim(EnemyPose(enemyRandomAttack));
+            enemySprite(EnemyPose(enemyRandomAttack)).drawFrame(1, attack.x, attack.y, attack.flipped);
             break;
+        }
         default:
 
             if (game_->level == 3)
             {
-                auto &spinningChainSprite = game_->sprites.at("spinning_chain");
-                spinningChainSprite.x = rotatingChainX;
-                spinningChainSprite.y = rotatingChainY;
-                spinningChainSprite._isPaused = game_->player->showHit_;
-                spinningChainSprite.updateAndDraw();
+                chainAnim_.x = rotatingChainX;
+                chainAnim_.y = rotatingChainY;
+                chainAnim_.flipped = isEnemyFlipped;
+                chainAnim_.paused = game_->player->showHit_;
+                game_->sprite(SpriteId::spinning_chain).updateAndDraw(chainAnim_);
             }
 
-            game_->sprites.at(enemies[game_->level - 1] + "_default")._isPaused = game_->player->showHit_;
-            game_->sprites.at(enemies[game_->level - 1] + "_default").updateAndDraw();
+            enemyAnim(EnemyPose::Default).paused = game_->player->showHit_;
+            enemySprite(EnemyPose::Default).updateAndDraw(enemyAnim(EnemyPose::Default));
 
             // check collision on *every* frame (or only on lastFrame, your choice)
             if (isCollidedWithPlayer())
@@ -850,21 +963,16 @@ void PlayState::renderEnemy()
     //flip checker
     if (enemyX < (game_->player->x)  && !isEnemyFlipped && enemyCurrentMove != EnemyAction::Punch && enemyCurrentMove != EnemyAction::Kick )
     {
-        flipEnemySprites();
+        flipEnemy();
     }
     if (enemyX > game_->player->x  && isEnemyFlipped && enemyCurrentMove != EnemyAction::Punch && enemyCurrentMove != EnemyAction::Kick )
     {
-        flipEnemySprites();
+        flipEnemy();
     }
 }
 
-void PlayState::flipEnemySprites()
+void PlayState::flipEnemy()
 {
-    for(int x = 0; x < enemySprites.size(); x++)
-    {
-        game_->sprites.at(enemies[game_->level - 1] + "_" + enemySprites[x]).invertHorizontally();   
-    }
-    game_->sprites.at("spinning_chain").invertHorizontally();
     isEnemyFlipped = !isEnemyFlipped;
 
     if (isEnemyFlipped)
@@ -891,8 +999,11 @@ void PlayState::reset()
     enemyEndState = EnemyEndSequence::Start;
     enemyMoveState = MoveState::FollowPlayer;
 
+    // hit sparks don't outlive the round
+    particles.clear();
+
     if (isEnemyFlipped)
     {
-        flipEnemySprites();
+        flipEnemy();
     }
 }
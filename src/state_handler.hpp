@@ -6,6 +6,10 @@
 
 
 #include "game_handler.hpp"
+#include "font_handler.hpp"
+#include "hud_handler.hpp"
+#include "particle_system.hpp"
+#include "sim_snapshot.hpp"
 #include "other.hpp"
 #include <random>
 
@@ -47,11 +51,6 @@ constexpr int StageBoundary        = 10;   ///< horizontal padding from edges
 constexpr int EndDelayHigh           = 2;  ///< longer pause
 constexpr int EndDelayLow            = 1;  ///< shorter pause
 
-//------------------------------------------------------------------------------
-// Font metrics
-//------------------------------------------------------------------------------
-constexpr int FontCharWidth          = 8;  ///< pixel width of each glyph
-
 /// Center `nChars` worth of text in the stage
 inline constexpr int centerText(int nChars) {
     return (StageWidth / 2) - ((nChars * FontCharWidth) / 2);
@@ -135,30 +134,28 @@ class State: public Timer
         
         Game*                                   game_;             ///< back-link
         bool                                    initialized_{};  ///< has init() run?
-        RenderTexture2D                         renderTexture_;      ///< offscreen target
+        BitmapFont                              font_;            ///< font_symbols sheet
+
+        /// Advance `blink` (if any); true while the text should be blanked
+        bool blinkHidden(TextBlink *blink);
 
-        // per-string blink timers
-        unordered_map<string, int> _frameTimer;
-        unordered_map<string, int> _currFrame;
+        /// Draw the state's unchanging content (drawStaticLayer) from a cached
+        /// render target, re-composing it only when `key` changes
+        void drawCachedStatic(int key);
+        /// Everything that stays the same while the drawCachedStatic key does
+        virtual void drawStaticLayer() {}
+
+        TextureHandle                           staticLayer_{};   ///< GAME_WIDTH x GAME_HEIGHT cache
+        int                                     staticKey_ = -1;  ///< key it was composed for
+
+        /// Timer and init flag, shared by every state's capture()/restore()
+        void captureBase(StateSnapshot &out) const;
+        void restoreBase(const StateSnapshot &in);
     public:
         State(Game *gm);
         virtual ~State();
-        inline void beginFrame() {
-            BeginDrawing();
-            BeginTextureMode(renderTexture_);
-            ClearBackground(BLACK);
-        }
-    
-        inline void endFrame() {
-            EndTextureMode();
-            Rectangle src = {0, 0, float(GAME_WIDTH), float(-GAME_HEIGHT)};
-            Rectangle dst = {
-                (SCREEN_WIDTH/2.0f) - ((SCREEN_WIDTH * (float(GAME_HEIGHT)/GAME_WIDTH))/2.0f),
-                0, SCREEN_WIDTH * (float(GAME_HEIGHT)/GAME_WIDTH), SCREEN_HEIGHT
-            };
-            DrawTexturePro(renderTexture_.texture, src, dst, {0,0}, 0, WHITE);
-            EndDrawing();
-        }
+        void beginFrame();   ///< start drawing into the platform's game frame
+        void endFrame();     ///< present the frame and poll input
     
         inline void draw() {
             beginFrame();
@@ -167,13 +164,24 @@ class State: public Timer
         }
 
         void run();
-        void drawText(const string &text, int x, int y, bool blink);
+
+        /// Draw runtime text; pass a TextBlink to make it blink
+        void drawText(std::string_view text, int x, int y, TextBlink *blink = nullptr);
+
+        /// Draw a compile-time GlyphRun (no per-character lookup at all)
+        template <std::size_t N>
+        inline void drawText(const GlyphRun<N> &run, int x, int y, TextBlink *blink = nullptr) {
+            font_.draw(run, x, y, blinkHidden(blink));
+        }
+
+        /// Draw an integer directly as digit glyphs
+        inline void drawNumber(int value, int x, int y) { font_.drawNumber(value, x, y); }
 
         /// Reset any subclass-specific members
         virtual void cleanUp();
 
-        /// Free GPU resources
-        void unloadTexture();
+        /// Free cached render targets (call before the platform goes away)
+        virtual void releaseRenderTargets();
         
 };
 
@@ -186,15 +194,20 @@ class IntroState : public State {
         void handleInput()       override;
         void init()        override;
         void drawStage()       override;
+        void drawStaticLayer()  override;
         void onBlinkingComplete()   override;
         void onTimeTick()        override;
         
         bool blinkEnter_{};// = false;
+        TextBlink enterBlink_;   ///< "press enter to start" blink state
         static constexpr int maxBlinks_ = 4;
         int blinkCount_ = 0; ///< how many times toggled so far
     public:
         bool canProceed = true;
         void cleanUp();
+
+        void capture(IntroSnapshot &out) const;
+        void restore(const IntroSnapshot &in);
 };
 
 //------------------------------------------------------------------------------
@@ -205,47 +218,71 @@ class PreviewState: public State
     using State::State;
     protected:
         void handleInput()       override { /* none */ }
-        void init()        override {}
+        void init()        override;
         void drawStage()       override;
         void onBlinkingComplete()   override {}
         void onTimeTick()        override;
     public:
         void cleanUp();
+
+        void capture(PreviewSnapshot &out) const;
+        void restore(const PreviewSnapshot &in);
 };
 
 class PlayState: public State 
 {
-    using State::State;
+    public:
+        /// Binds the HUD to the values it shows, once: a restored PlayState
+        /// skips init() and must still draw it
+        explicit PlayState(Game *gm);
     protected:
         void handleInput();
         void drawStage();
+        void drawStaticLayer() override;  ///< background + HUD labels, per level
         void init();
         void onBlinkingComplete();
         void onTimeTick();
+        Hud hud_;   ///< score, lives, health gauges
     public:
         void cleanUp();
         void reset();
         void run();
+        void releaseRenderTargets() override;
+
+        /// Enemy, round and end-sequence state (not the hit sparks)
+        void capture(PlaySnapshot &out) const;
+        void restore(const PlaySnapshot &in);
 
         /// Advance the “end of level” state machine for the player’s victory/loss sequence.
         void processEndState();
 
         /// Advance the “end of level” state machine for the enemy’s victory/loss sequence.
         void processEnemyEndState();
-        int enemyHealth;
-        int enemyX, enemyY;
+        int enemyHealth{};
+        int enemyX{}, enemyY{};
         EnemyAction enemyCurrentMove = EnemyAction::None;
 
         int retreatCounter{};    ///< how far enemy has run back //enemyMovementCounter;
 
-        /// Update the position of every non-attack enemy sprite frame.
+        /// Move the non-attack enemy animations to the enemy and face them
+        /// the enemy's way.
         ///
-        /// Skips attack-only frames (“hit”, “punch”, “kick”) which are placed
+        /// Skips attack-only poses (“hit”, “punch”, “kick”) which are placed
         /// dynamically during attack processing.
-        void updateEnemySpritePositions();
+        void updateEnemyAnimPositions();
 
         void renderEnemy();
 
+        /// Sprite sheet of the current level's enemy in the given pose
+        Sprite& enemySprite(EnemyPose pose);
+
+        /// Animation cursor of the current level's enemy in the given pose
+        SpriteAnim& enemyAnim(EnemyPose pose);
+
+        /// Each level's enemy keeps its own cursors across rounds
+        std::array<std::array<SpriteAnim, EnemyPoseCount>, EnemyCount> enemyAnims_{};
+        SpriteAnim chainAnim_{};                               ///< level-3 spinning chain
+
         /// Evaluate and advance the enemy’s movement state machine.
         // This is not just raw physics but a state machine/AI step.
         void updateEnemyMovementState();
@@ -259,10 +296,15 @@ class PlayState: public State
         /// Choose and begin a basic attack (kick or punch) at random
         void enemyBasicAttack();
 
+        /// Versus: walk or attack as the second player's keys say
+        /// (Left/Right walk, A punches, S kicks)
+        void enemyFollowInput();
+
         /// @returns true if the player is within the enemy’s engagement range
         bool playerInRange();
     
-        void flipEnemySprites();
+        /// Turn the enemy around (its poses are drawn mirrored while flipped)
+        void flipEnemy();
         
         /// Queue up the “end‐of‐round” choreography based on the given player action
         /// @param actionID   ID of the player’s finishing move
@@ -271,13 +313,15 @@ class PlayState: public State
         void prepareEndOfRoundChoreography(int actionID, bool flipSprite, bool playSfx);
 
         bool isEnemyFlipped = false;
+
+        ParticleSystem particles{PARTICLE_CAPACITY};  ///< hit sparks, cleared every round
         
         bool pauseMovement{};    ///< freeze all motion
-        int rotatingChainX, rotatingChainY;     ///< level-3 weapon spin pos
+        int rotatingChainX{}, rotatingChainY{};     ///< level-3 weapon spin pos
 
-        int haltTime;
-        int haltTimeHit;
-        int maxHaltTime;
+        int haltTime{};
+        int haltTimeHit{};
+        int maxHaltTime{};
 
         // state‐machine vars
         EndSequence endState = EndSequence::Start;
@@ -292,7 +336,7 @@ class PlayState: public State
         /// Apply the results of a collision (shake, health loss, knockback)
         void processCollisionWithPlayer();
         
-        bool renderEnemyHit;
+        bool renderEnemyHit{};
         void resetEnemyMove();
 
         /// Compute the player’s collision box for the current attack
@@ -326,10 +370,6 @@ const vector<EnemyAction> attackList = {
 };
 
 
-const vector<string> enemySprites = {
-    "kick", "punch", "default", "defeated", "hit"
-};
-
 // collision boxes for each enemy’s body (idle / walk / run, etc.)
 const vector<CollisionInfo> enemyBodyHitBoxes = {
     {5, 8, 8, 19, 31, 10},
@@ -368,7 +408,7 @@ const vector<CollisionInfo> chainAttackHitBoxes  = {
 };
 
 const vector<string> enemies = {
-    "wang", "tao", "chen", "lang", "mu"
+    KUNGFU_ENEMIES(KUNGFU_ASSET_NAME)
 };
 
 #endif 
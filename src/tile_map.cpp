@@ -0,0 +1,130 @@
+// tile_map.cpp
+#include "tile_map.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr std::size_t TileBytes = std::size_t(TileSize) * TileSize * 4;
+
+    inline int cellsFor(std::uint32_t pixels) { return int((pixels + TileSize - 1) / TileSize); }
+}
+
+bool TileMap::load(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    if (!ifs) return false;
+    std::vector<std::uint8_t> bytes(std::size_t(ifs.tellg()));
+    ifs.seekg(0);
+    if (!ifs.read(reinterpret_cast<char*>(bytes.data()), std::streamsize(bytes.size()))) return false;
+    return parse(bytes.data(), bytes.size());
+}
+
+bool TileMap::parse(const std::uint8_t *data, std::size_t size)
+{
+    TileMapHeader header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != TileMapMagic || header.version != TileMapVersion
+        || int(header.columns) != cellsFor(header.width) || int(header.rows) != cellsFor(header.height)
+        || header.tileCount == 0 || header.tileCount > TileMapEntry::MaxTiles)
+        return false;
+
+    const std::size_t cellCount = std::size_t(header.columns) * header.rows;
+    const std::size_t tileBytes = header.tileCount * TileBytes;
+    if (size != sizeof(header) + cellCount * sizeof(std::uint16_t) + tileBytes) return false;
+
+    std::vector<std::uint16_t> cells(cellCount);
+    std::memcpy(cells.data(), data + sizeof(header), cellCount * sizeof(std::uint16_t));
+    for (std::uint16_t c : cells) {
+        if ((c & TileMapEntry::IndexMask) >= header.tileCount) return false;
+    }
+
+    header_ = header;
+    cells_  = std::move(cells);
+    tiles_.assign(data + sizeof(header) + cellCount * sizeof(std::uint16_t), data + size);
+    buildRuns();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Runs: tile i sits right of tile i - 1 in the texture (same texture row), so
+// cells holding i, i + 1, ... draw as one wide rect. Mirrored cells holding
+// i, i - 1, ... draw as one mirrored rect. Fully transparent tiles (padding)
+// are not drawn at all.
+//------------------------------------------------------------------------------
+void TileMap::buildRuns()
+{
+    std::vector<bool> blank(header_.tileCount);
+    for (std::size_t t = 0; t < blank.size(); t++) {
+        const std::uint8_t *px = tiles_.data() + t * TileBytes;
+        bool empty = true;
+        for (std::size_t k = 3; k < TileBytes && empty; k += 4) empty = px[k] == 0;
+        blank[t] = empty;
+    }
+
+    runs_.clear();
+    const int columns = int(header_.columns);
+    for (int row = 0; row < int(header_.rows); row++) {
+        const std::uint16_t *cells = cells_.data() + std::size_t(row) * columns;
+        for (int col = 0; col < columns; ) {
+            const std::uint16_t flips = cells[col] & ~TileMapEntry::IndexMask;
+            const int           first = cells[col] & TileMapEntry::IndexMask;
+            if (blank[std::size_t(first)]) { col++; continue; }
+
+            const int step = (flips & TileMapEntry::FlipX) ? -1 : 1;
+            int count = 1;
+            while (col + count < columns) {
+                const std::uint16_t next  = cells[col + count];
+                const int           index = first + step * count;
+                if ((next & ~TileMapEntry::IndexMask) != flips || (next & TileMapEntry::IndexMask) != index
+                    || index / TextureColumns != first / TextureColumns)
+                    break;
+                count++;
+            }
+
+            const int left = step > 0 ? first : first - count + 1;  // leftmost tile in the texture
+            Run run;
+            run.src = { float(left % TextureColumns * TileSize), float(left / TextureColumns * TileSize),
+                        float(step * count * TileSize),
+                        float((flips & TileMapEntry::FlipY) ? -TileSize : TileSize) };
+            run.x = col * TileSize;
+            run.y = row * TileSize;
+            runs_.push_back(run);
+            col += count;
+        }
+    }
+}
+
+bool TileMap::upload(Platform &platform)
+{
+    if (tiles_.empty()) return false;
+
+    // Tile t goes to cell (t % TextureColumns, t / TextureColumns)
+    const int count  = int(header_.tileCount);
+    const int width  = (count < TextureColumns ? count : TextureColumns) * TileSize;
+    const int height = (count + TextureColumns - 1) / TextureColumns * TileSize;
+    std::vector<std::uint8_t> rgba(std::size_t(width) * height * 4, 0);
+    for (int t = 0; t < count; t++) {
+        const std::uint8_t *src = tiles_.data() + std::size_t(t) * TileBytes;
+        std::uint8_t *dst = rgba.data()
+            + (std::size_t(t / TextureColumns * TileSize) * width + t % TextureColumns * TileSize) * 4;
+        for (int y = 0; y < TileSize; y++)
+            std::memcpy(dst + std::size_t(y) * width * 4, src + std::size_t(y) * TileSize * 4, TileSize * 4);
+    }
+
+    texture_ = platform.loadTextureFromPixels(width, height, rgba.data());
+    std::vector<std::uint8_t>().swap(tiles_);  // the texture has them now
+    return texture_.id != 0;
+}
+
+void TileMap::release(Platform &platform)
+{
+    if (texture_.id != 0) platform.unloadTexture(texture_);
+}
+
+void TileMap::draw(Platform &platform, int x, int y, DrawLayer layer) const
+{
+    for (const Run &run : runs_)
+        platform.drawTexture(texture_, run.src, float(x + run.x), float(y + run.y), layer);
+}
@@ -0,0 +1,100 @@
+#ifndef _TILE_MAP_H_
+#define _TILE_MAP_H_
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "platform_handler.hpp"
+
+//------------------------------------------------------------------------------
+// Tile-mapped backgrounds, the way the arcade board drew them: a set of
+// unique TileSize x TileSize tiles plus a map saying which tile (and which
+// mirroring of it) covers each cell.
+//
+// tools/tile_converter.cpp cuts background PNGs into tiles offline, keeps
+// one copy of every tile that repeats (as is, or mirrored), and writes a
+// .tmap file per background. At runtime the tiles become one small texture
+// and the map says where to draw them.
+//
+// File layout (little-endian):
+//   TileMapHeader
+//   std::uint16_t cells[columns * rows]     row-major TileMapEntry values
+//   tiles, tileCount * TileSize * TileSize RGBA8 pixels, tile after tile
+//------------------------------------------------------------------------------
+constexpr std::uint32_t TileMapMagic   = 0x504D544B;  ///< "KTMP"
+constexpr std::uint32_t TileMapVersion = 1;
+constexpr int           TileSize       = 8;
+constexpr char          TileMapExtension[] = ".tmap";
+
+/// One map cell: tile index plus mirroring
+namespace TileMapEntry {
+    constexpr std::uint16_t FlipX     = 0x4000;  ///< draw the tile mirrored left-right
+    constexpr std::uint16_t FlipY     = 0x8000;  ///< draw the tile upside down
+    constexpr std::uint16_t IndexMask = 0x3FFF;
+    constexpr std::uint32_t MaxTiles  = IndexMask + 1;
+}
+
+struct TileMapHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t width;      ///< source image size in pixels
+    std::uint32_t height;
+    std::uint32_t columns;    ///< map size in cells
+    std::uint32_t rows;
+    std::uint32_t tileCount;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(TileMapHeader) == 32, "tile map header layout");
+
+//------------------------------------------------------------------------------
+// TileMap: a loaded .tmap. upload() turns the tiles into a texture (and
+// drops the CPU copy); draw() then costs one draw call per run of cells
+// whose tiles sit side by side in that texture, not one per cell.
+//------------------------------------------------------------------------------
+class TileMap {
+public:
+    /// Read a .tmap file. False if missing or invalid.
+    bool load(const std::string &path);
+    /// Same as load(), from memory (e.g. an archive blob)
+    bool parse(const std::uint8_t *data, std::size_t size);
+
+    /// Create the tile texture on `platform`. Call once after load()/parse().
+    bool upload(Platform &platform);
+    void release(Platform &platform);
+    inline bool isReady() const { return texture_.id != 0; }
+
+    /// Draw the whole map with its top-left corner at (x, y)
+    void draw(Platform &platform, int x, int y, DrawLayer layer) const;
+
+    inline int width() const        { return int(header_.width); }
+    inline int height() const       { return int(header_.height); }
+    inline int cellCount() const    { return int(cells_.size()); }
+    inline int tileCount() const    { return int(header_.tileCount); }
+    inline std::size_t drawCount() const { return runs_.size(); }
+
+    /// Tiles per row of the uploaded texture
+    static constexpr int TextureColumns = 32;
+
+private:
+    /// A horizontal run of cells drawn with one call
+    struct Run {
+        Rect src;     ///< inside texture_ (negative size = mirrored)
+        int  x, y;    ///< offset from the map origin
+    };
+
+    /// Merge cells into runs_ (needs header_, cells_ and tiles_)
+    void buildRuns();
+
+    TileMapHeader               header_{};
+    std::vector<std::uint16_t>  cells_;
+    std::vector<std::uint8_t>   tiles_;    ///< RGBA8, freed by upload()
+    std::vector<Run>            runs_;
+    TextureHandle               texture_{};
+};
+
+#endif
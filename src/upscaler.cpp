@@ -0,0 +1,484 @@
+// upscaler.cpp
+#include "upscaler.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const char *const filterNames[] = { "nearest", "scale2x", "scale3x", "xbr" };
+    static_assert(sizeof(filterNames) / sizeof(filterNames[0]) == std::size_t(UpscaleFilter::Count),
+                  "one name per UpscaleFilter");
+
+    /// a + (b - a) * w / 256, per channel
+    inline std::uint32_t blend(std::uint32_t a, std::uint32_t b, std::uint32_t w)
+    {
+        std::uint32_t rb = ((a & 0x00FF00FFu) * (256 - w) + (b & 0x00FF00FFu) * w) >> 8;
+        std::uint32_t ga = (((a >> 8) & 0x00FF00FFu) * (256 - w) + ((b >> 8) & 0x00FF00FFu) * w) >> 8;
+        return (rb & 0x00FF00FFu) | ((ga & 0x00FF00FFu) << 8);
+    }
+
+#if defined(__SSE2__)
+    inline __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+    /// m ? a : b, per lane
+    inline __m128i select(__m128i m, __m128i a, __m128i b) {
+        return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+    }
+    inline __m128i load(const std::uint32_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    inline void store(std::uint32_t *p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+    /// Store a0 b0 c0 a1 b1 c1 a2 b2 c2 a3 b3 c3
+    inline void storeInterleaved3(std::uint32_t *p, __m128i a, __m128i b, __m128i c)
+    {
+        __m128 ab   = _mm_castsi128_ps(_mm_unpacklo_epi32(a, b));  // a0 b0 a1 b1
+        __m128 ac   = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(c), _MM_SHUFFLE(1, 0, 1, 0));  // a0 a1 c0 c1
+        __m128 bcLo = _mm_castsi128_ps(_mm_unpacklo_epi32(b, c));  // b0 c0 b1 c1
+        __m128 abHi = _mm_castsi128_ps(_mm_unpackhi_epi32(a, b));  // a2 b2 a3 b3
+        __m128 caHi = _mm_castsi128_ps(_mm_unpackhi_epi32(c, a));  // c2 a2 c3 a3
+        __m128 bcHi = _mm_castsi128_ps(_mm_unpackhi_epi32(b, c));  // b2 c2 b3 c3
+        store(p,     _mm_castps_si128(_mm_shuffle_ps(ab,   ac,   _MM_SHUFFLE(1, 2, 1, 0))));
+        store(p + 4, _mm_castps_si128(_mm_shuffle_ps(bcLo, abHi, _MM_SHUFFLE(1, 0, 3, 2))));
+        store(p + 8, _mm_castps_si128(_mm_shuffle_ps(caHi, bcHi, _MM_SHUFFLE(3, 2, 3, 0))));
+    }
+#endif
+}
+
+const char* upscaleFilterName(UpscaleFilter filter)
+{
+    return filter < UpscaleFilter::Count ? filterNames[int(filter)] : "?";
+}
+
+bool parseUpscaleFilter(const std::string &name, UpscaleFilter &out)
+{
+    for (int i = 0; i < int(UpscaleFilter::Count); i++) {
+        if (name == filterNames[i]) { out = UpscaleFilter(i); return true; }
+    }
+    return false;
+}
+
+Upscaler::Upscaler(UpscaleFilter filter, int nearestFactor)
+{
+    setFilter(filter, nearestFactor);
+}
+
+void Upscaler::setFilter(UpscaleFilter filter, int nearestFactor)
+{
+    filter_        = filter;
+    nearestFactor_ = std::max(1, nearestFactor);
+}
+
+int Upscaler::factor() const
+{
+    switch (filter_) {
+        case UpscaleFilter::Scale3x: return 3;
+        case UpscaleFilter::Scale2x:
+        case UpscaleFilter::Xbr2x:   return 2;
+        default:                     return nearestFactor_;
+    }
+}
+
+void Upscaler::run(const std::uint32_t *src, int width, int height)
+{
+    pad(src, width, height);
+    outWidth_  = width  * factor();
+    outHeight_ = height * factor();
+    out_.resize(std::size_t(outWidth_) * outHeight_);
+
+    switch (filter_) {
+        case UpscaleFilter::Scale2x: scale2x(); break;
+        case UpscaleFilter::Scale3x: scale3x(); break;
+        case UpscaleFilter::Xbr2x:   xbr2x();   break;
+        default:                     nearest(); break;
+    }
+}
+
+void Upscaler::pad(const std::uint32_t *src, int width, int height)
+{
+    width_  = width;
+    height_ = height;
+    stride_ = width + 2 * Border;
+    padded_.resize(std::size_t(stride_) * (height + 2 * Border));
+
+    for (int py = 0; py < height + 2 * Border; py++) {
+        const std::uint32_t *row = src + std::size_t(std::clamp(py - Border, 0, height - 1)) * width;
+        std::uint32_t       *dst = &padded_[std::size_t(py) * stride_];
+        std::fill(dst, dst + Border, row[0]);
+        std::memcpy(dst + Border, row, std::size_t(width) * sizeof(std::uint32_t));
+        std::fill(dst + Border + width, dst + stride_, row[width - 1]);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Nearest: widen one row, then copy it n - 1 times
+//------------------------------------------------------------------------------
+void Upscaler::nearest()
+{
+    const int n = nearestFactor_;
+    for (int y = 0; y < height_; y++) {
+        const std::uint32_t *s = &padded_[std::size_t(y + Border) * stride_ + Border];
+        std::uint32_t       *d = &out_[std::size_t(y) * n * outWidth_];
+
+        int x = 0;
+#if defined(__SSE2__)
+        if (n == 2) {
+            for (; x + 4 <= width_; x += 4) {
+                __m128i v = load(s + x);
+                store(d + 2 * x,     _mm_unpacklo_epi32(v, v));
+                store(d + 2 * x + 4, _mm_unpackhi_epi32(v, v));
+            }
+        }
+        else if (n == 3) {
+            for (; x + 4 <= width_; x += 4) {
+                __m128i v = load(s + x);
+                storeInterleaved3(d + 3 * x, v, v, v);
+            }
+        }
+        else if (n == 4) {
+            for (; x + 4 <= width_; x += 4) {
+                __m128i v = load(s + x);
+                store(d + 4 * x,      _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 0, 0, 0)));
+                store(d + 4 * x + 4,  _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 1, 1)));
+                store(d + 4 * x + 8,  _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 2, 2)));
+                store(d + 4 * x + 12, _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3)));
+            }
+        }
+#endif
+        for (; x < width_; x++)
+            std::fill(d + x * n, d + x * n + n, s[x]);
+
+        for (int r = 1; r < n; r++)
+            std::memcpy(d + std::size_t(r) * outWidth_, d, std::size_t(outWidth_) * sizeof(std::uint32_t));
+    }
+}
+
+//------------------------------------------------------------------------------
+// Scale2x. Around E:   A B C
+//                      D E F      E0 E1
+//                      G H I  ->  E2 E3
+//------------------------------------------------------------------------------
+void Upscaler::scale2x()
+{
+    const std::size_t P = std::size_t(stride_);
+    for (int y = 0; y < height_; y++) {
+        const std::uint32_t *e   = &padded_[std::size_t(y + Border) * P + Border];
+        std::uint32_t       *top = &out_[std::size_t(y) * 2 * outWidth_];
+        std::uint32_t       *bot = top + outWidth_;
+
+        int x = 0;
+#if defined(__SSE2__)
+        for (; x + 4 <= width_; x += 4) {
+            __m128i E = load(e + x),     B = load(e + x - P), H = load(e + x + P);
+            __m128i D = load(e + x - 1), F = load(e + x + 1);
+            __m128i off = _mm_or_si128(eq(B, H), eq(D, F));  // no edge through E
+
+            __m128i e0 = select(_mm_andnot_si128(off, eq(D, B)), D, E);
+            __m128i e1 = select(_mm_andnot_si128(off, eq(B, F)), F, E);
+            __m128i e2 = select(_mm_andnot_si128(off, eq(D, H)), D, E);
+            __m128i e3 = select(_mm_andnot_si128(off, eq(H, F)), F, E);
+            store(top + 2 * x,     _mm_unpacklo_epi32(e0, e1));
+            store(top + 2 * x + 4, _mm_unpackhi_epi32(e0, e1));
+            store(bot + 2 * x,     _mm_unpacklo_epi32(e2, e3));
+            store(bot + 2 * x + 4, _mm_unpackhi_epi32(e2, e3));
+        }
+#endif
+        for (; x < width_; x++) {
+            std::uint32_t E = e[x], B = e[x - P], H = e[x + P], D = e[x - 1], F = e[x + 1];
+            bool edge = B != H && D != F;
+            top[2 * x]     = edge && D == B ? D : E;
+            top[2 * x + 1] = edge && B == F ? F : E;
+            bot[2 * x]     = edge && D == H ? D : E;
+            bot[2 * x + 1] = edge && H == F ? F : E;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Scale3x: same neighbourhood, 3x3 output E0..E8 (E4 = E)
+//------------------------------------------------------------------------------
+void Upscaler::scale3x()
+{
+    const std::size_t P = std::size_t(stride_);
+    for (int y = 0; y < height_; y++) {
+        const std::uint32_t *e  = &padded_[std::size_t(y + Border) * P + Border];
+        std::uint32_t       *r0 = &out_[std::size_t(y) * 3 * outWidth_];
+        std::uint32_t       *r1 = r0 + outWidth_;
+        std::uint32_t       *r2 = r1 + outWidth_;
+
+        int x = 0;
+#if defined(__SSE2__)
+        for (; x + 4 <= width_; x += 4) {
+            __m128i A = load(e + x - P - 1), B = load(e + x - P), C = load(e + x - P + 1);
+            __m128i D = load(e + x - 1),     E = load(e + x),     F = load(e + x + 1);
+            __m128i G = load(e + x + P - 1), H = load(e + x + P), I = load(e + x + P + 1);
+            __m128i off = _mm_or_si128(eq(B, H), eq(D, F));
+
+            __m128i db = _mm_andnot_si128(off, eq(D, B)), bf = _mm_andnot_si128(off, eq(B, F));
+            __m128i dh = _mm_andnot_si128(off, eq(D, H)), hf = _mm_andnot_si128(off, eq(H, F));
+            __m128i ea = eq(E, A), ec = eq(E, C), eg = eq(E, G), ei = eq(E, I);
+
+            __m128i e1 = select(_mm_or_si128(_mm_andnot_si128(ec, db), _mm_andnot_si128(ea, bf)), B, E);
+            __m128i e3 = select(_mm_or_si128(_mm_andnot_si128(eg, db), _mm_andnot_si128(ea, dh)), D, E);
+            __m128i e5 = select(_mm_or_si128(_mm_andnot_si128(ei, bf), _mm_andnot_si128(ec, hf)), F, E);
+            __m128i e7 = select(_mm_or_si128(_mm_andnot_si128(ei, dh), _mm_andnot_si128(eg, hf)), H, E);
+            storeInterleaved3(r0 + 3 * x, select(db, D, E), e1, select(bf, F, E));
+            storeInterleaved3(r1 + 3 * x, e3, E, e5);
+            storeInterleaved3(r2 + 3 * x, select(dh, D, E), e7, select(hf, F, E));
+        }
+#endif
+        for (; x < width_; x++) {
+            std::uint32_t A = e[x - P - 1], B = e[x - P], C = e[x - P + 1];
+            std::uint32_t D = e[x - 1],     E = e[x],     F = e[x + 1];
+            std::uint32_t G = e[x + P - 1], H = e[x + P], I = e[x + P + 1];
+            bool edge = B != H && D != F;
+            bool db = edge && D == B, bf = edge && B == F, dh = edge && D == H, hf = edge && H == F;
+
+            r0[3 * x]     = db ? D : E;
+            r0[3 * x + 1] = (db && E != C) || (bf && E != A) ? B : E;
+            r0[3 * x + 2] = bf ? F : E;
+            r1[3 * x]     = (db && E != G) || (dh && E != A) ? D : E;
+            r1[3 * x + 1] = E;
+            r1[3 * x + 2] = (bf && E != I) || (hf && E != C) ? F : E;
+            r2[3 * x]     = dh ? D : E;
+            r2[3 * x + 1] = (dh && E != I) || (hf && E != G) ? H : E;
+            r2[3 * x + 2] = hf ? F : E;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// xBR-style 2x. Each of E's four output pixels is a corner; for the
+// bottom-right one the 5x5 window is named
+//
+//            A1 B1 C1
+//         A0 A  B  C  C4
+//         D0 D  E  F  F4
+//         G0 G  H  I  I4
+//            G5 H5 I5
+//
+// and the other three corners use the same names mirrored. Every distance
+// the rule needs is between two pixels one of eight offsets apart, so those
+// are computed once per frame (8 pixels per step) into a plane per offset,
+// and a corner only loads them. With SSE2 four pixels are decided and
+// blended per step; groups of four flat pixels (E equal to its four
+// neighbours) skip the corners.
+//------------------------------------------------------------------------------
+namespace {
+    /// dist_[k][i] compares padded pixel i with the one xbrDirectionXY[k] from it
+    const int xbrDirectionXY[][2] = { {1,0}, {0,1}, {1,1}, {-1,1}, {2,1}, {-2,1}, {1,2}, {-1,2} };
+
+#if defined(__SSE2__)
+    /// Four plane entries, widened to 32-bit lanes
+    inline __m128i load4x16(const std::int16_t *p)
+    {
+        return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128());
+    }
+
+    /// blend() with a weight per pixel (0..256, one per 32-bit lane)
+    inline __m128i blend4(__m128i a, __m128i b, __m128i w)
+    {
+        const __m128i zero = _mm_setzero_si128(), full = _mm_set1_epi16(256);
+        w = _mm_or_si128(w, _mm_slli_epi32(w, 16));
+        auto mix = [&](__m128i a16, __m128i b16, __m128i w16) {  // products stay below 2^16
+            return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(a16, _mm_sub_epi16(full, w16)),
+                                                _mm_mullo_epi16(b16, w16)), 8);
+        };
+        return _mm_packus_epi16(mix(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi32(w, w)),
+                                mix(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi32(w, w)));
+    }
+#endif
+}
+
+void Upscaler::xbr2x()
+{
+    const std::size_t P = std::size_t(stride_);
+    const std::size_t N = padded_.size();
+
+    // Luma/chroma per padded pixel (8.8 fixed point weights)
+    y_.resize(N); u_.resize(N); v_.resize(N);
+    for (std::size_t i = 0; i < N; i++) {
+        int r = int(padded_[i] & 0xFF), g = int((padded_[i] >> 8) & 0xFF), b = int((padded_[i] >> 16) & 0xFF);
+        y_[i] = std::int16_t(( 77 * r + 150 * g +  29 * b) >> 8);
+        u_[i] = std::int16_t((-43 * r -  85 * g + 128 * b) >> 8);
+        v_[i] = std::int16_t((128 * r - 107 * g -  21 * b) >> 8);
+    }
+    constexpr int Same = 155;  // distances below this count as the same color
+    auto df = [this](std::size_t a, std::size_t b) {
+        return 48 * std::abs(y_[a] - y_[b]) + 7 * std::abs(u_[a] - u_[b]) + 6 * std::abs(v_[a] - v_[b]);
+    };
+
+    // dist_[k][i] = df(i, i + offset k); the weighted sum stays below 2^15
+#if defined(__SSE2__)
+    const __m128i wy = _mm_set1_epi16(48), wu = _mm_set1_epi16(7), wv = _mm_set1_epi16(6);
+    auto absDiff = [](__m128i a, __m128i b) {
+        __m128i d = _mm_sub_epi16(a, b);
+        return _mm_max_epi16(d, _mm_sub_epi16(_mm_setzero_si128(), d));
+    };
+    auto load16 = [](const std::int16_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+    auto dist8 = [&](std::size_t a, std::size_t b) {
+        return _mm_add_epi16(_mm_add_epi16(
+                   _mm_mullo_epi16(absDiff(load16(&y_[a]), load16(&y_[b])), wy),
+                   _mm_mullo_epi16(absDiff(load16(&u_[a]), load16(&u_[b])), wu)),
+                   _mm_mullo_epi16(absDiff(load16(&v_[a]), load16(&v_[b])), wv));
+    };
+#endif
+    for (int k = 0; k < XbrDirections; k++) {
+        const std::size_t delta = std::size_t(long(xbrDirectionXY[k][1]) * long(P) + xbrDirectionXY[k][0]);
+        std::vector<std::int16_t> &plane = dist_[k];
+        plane.resize(N);
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        for (; i + 8 + delta <= N; i += 8)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&plane[i]), dist8(i, i + delta));
+#endif
+        for (; i + delta < N; i++) plane[i] = std::int16_t(df(i, i + delta));
+        std::fill(plane.begin() + long(i), plane.end(), std::int16_t(0));  // past the last row: never read
+    }
+
+    // Per corner: where each named pixel is relative to E, and which plane
+    // entry holds each distance the rule uses
+    enum Pos { pB, pC, pD, pF, pG, pH, pI, pF4, pI4, pH5, pI5, PosCount };
+    enum Pair { EC, EG, IH5, IF4, HF, HD, HI5, FI4, FB, EI, FG, HC, EF, EH, PairCount };
+    static const int posXY[PosCount][2] = { {0,-1}, {1,-1}, {-1,0}, {1,0}, {-1,1}, {0,1}, {1,1},
+                                            {2,0}, {2,1}, {0,2}, {1,2} };
+    static const int pairPos[PairCount][2] = { {-1,pC}, {-1,pG}, {pI,pH5}, {pI,pF4}, {pH,pF}, {pH,pD},
+                                               {pH,pI5}, {pF,pI4}, {pF,pB}, {-1,pI}, {pF,pG}, {pH,pC},
+                                               {-1,pF}, {-1,pH} };  // -1 = E
+    struct Corner {
+        long                off[PosCount];
+        const std::int16_t *plane[PairCount];
+        long                planeOff[PairCount];
+        int                 cx, cy;   ///< which output pixel is the corner
+    } corners[4];
+    for (int c = 0; c < 4; c++) {
+        const int sx = (c & 1) ? 1 : -1, sy = (c & 2) ? 1 : -1;
+        Corner &k = corners[c];
+        for (int p = 0; p < PosCount; p++) k.off[p] = posXY[p][1] * sy * long(P) + posXY[p][0] * sx;
+        for (int q = 0; q < PairCount; q++) {
+            int ax = 0, ay = 0, bx = posXY[pairPos[q][1]][0] * sx, by = posXY[pairPos[q][1]][1] * sy;
+            if (pairPos[q][0] >= 0) {
+                ax = posXY[pairPos[q][0]][0] * sx;
+                ay = posXY[pairPos[q][0]][1] * sy;
+            }
+            if (by < ay || (by == ay && bx < ax)) { std::swap(ax, bx); std::swap(ay, by); }  // planes look down/right
+            int dir = 0;
+            while (xbrDirectionXY[dir][0] != bx - ax || xbrDirectionXY[dir][1] != by - ay) dir++;
+            k.plane[q]    = dist_[dir].data();
+            k.planeOff[q] = ay * long(P) + ax;
+        }
+        k.cx = sx > 0;
+        k.cy = sy > 0;
+    }
+
+    for (int y = 0; y < height_; y++) {
+        const std::size_t rowStart = std::size_t(y + Border) * P + Border;
+        std::uint32_t    *top      = &out_[std::size_t(y) * 2 * outWidth_];
+        std::uint32_t    *bot      = top + outWidth_;
+
+        int x = 0;
+#if defined(__SSE2__)
+        const __m128i ones = _mm_set1_epi32(-1), same = _mm_set1_epi32(Same), almostSame = _mm_set1_epi32(Same - 1);
+        auto lt = [](__m128i a, __m128i b) { return _mm_cmplt_epi32(a, b); };
+        for (; x + 4 <= width_; x += 4) {
+            const std::size_t    e0 = rowStart + std::size_t(x);
+            const std::uint32_t *e  = &padded_[e0];
+            const __m128i E = load(e);
+            __m128i out[2][2] = { { E, E }, { E, E } };
+
+            __m128i flat = _mm_and_si128(_mm_and_si128(eq(E, load(e - P)), eq(E, load(e + P))),
+                                         _mm_and_si128(eq(E, load(e - 1)), eq(E, load(e + 1))));
+            for (const Corner &k : corners) {
+                if (_mm_movemask_epi8(flat) == 0xFFFF) break;  // widen E only
+
+                const __m128i F = load(e + k.off[pF]), H = load(e + k.off[pH]);
+                __m128i edge = _mm_andnot_si128(_mm_or_si128(eq(E, F), eq(E, H)), ones);
+                if (_mm_movemask_epi8(edge) == 0) continue;
+
+                // the edge test first, the distances only a blend needs after it
+                __m128i d[PairCount];
+                for (int q = 0; q < FG; q++) d[q] = load4x16(k.plane[q] + long(e0) + k.planeOff[q]);
+
+                __m128i across = _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(d[EC], d[EG]), _mm_add_epi32(d[IH5], d[IF4])),
+                                               _mm_slli_epi32(d[HF], 2));
+                __m128i along  = _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(d[HD], d[HI5]), _mm_add_epi32(d[FI4], d[FB])),
+                                               _mm_slli_epi32(d[EI], 2));
+                auto apartFrom = [&](__m128i v) { return _mm_cmpgt_epi32(v, almostSame); };  // v >= Same
+                __m128i apart  = _mm_or_si128(_mm_or_si128(_mm_and_si128(apartFrom(d[FB]), apartFrom(d[HD])),
+                                                           _mm_and_si128(lt(d[EI], same),
+                                                                         _mm_and_si128(apartFrom(d[FI4]), apartFrom(d[HI5])))),
+                                              _mm_or_si128(lt(d[EG], same), lt(d[EC], same)));
+                edge = _mm_and_si128(edge, _mm_and_si128(lt(across, along), apart));
+                if (_mm_movemask_epi8(edge) == 0) continue;
+
+                for (int q = FG; q < PairCount; q++) d[q] = load4x16(k.plane[q] + long(e0) + k.planeOff[q]);
+                const __m128i B = load(e + k.off[pB]), C = load(e + k.off[pC]);
+                const __m128i D = load(e + k.off[pD]), G = load(e + k.off[pG]);
+                const __m128i shallow = _mm_andnot_si128(_mm_or_si128(lt(d[HC], _mm_slli_epi32(d[FG], 1)),
+                                                                      _mm_or_si128(eq(E, G), eq(D, G))), edge);
+                const __m128i steep   = _mm_andnot_si128(_mm_or_si128(lt(d[FG], _mm_slli_epi32(d[HC], 1)),
+                                                                      _mm_or_si128(eq(E, C), eq(B, C))), edge);
+                const __m128i both    = _mm_and_si128(shallow, steep);
+                const __m128i px      = select(lt(d[EH], d[EF]), H, F);
+
+                const __m128i w3 = _mm_and_si128(edge, select(both, _mm_set1_epi32(224),
+                                                       select(_mm_or_si128(shallow, steep), _mm_set1_epi32(192),
+                                                              _mm_set1_epi32(128))));
+                const __m128i w2 = _mm_and_si128(shallow, _mm_set1_epi32(64));
+                const __m128i w1 = _mm_and_si128(_mm_andnot_si128(shallow, steep), _mm_set1_epi32(64));
+
+                __m128i &n3 = out[k.cy][k.cx];      // the corner itself
+                __m128i &n2 = out[k.cy][1 - k.cx];  // beside it (shallow edges)
+                __m128i &n1 = out[1 - k.cy][k.cx];  // above/below it (steep edges)
+                n3 = blend4(n3, px, w3);
+                if (_mm_movemask_epi8(_mm_or_si128(shallow, steep)) != 0) {
+                    n2 = blend4(n2, px, w2);
+                    n1 = select(both, n2, blend4(n1, px, w1));
+                }
+            }
+            store(top + 2 * x,     _mm_unpacklo_epi32(out[0][0], out[0][1]));
+            store(top + 2 * x + 4, _mm_unpackhi_epi32(out[0][0], out[0][1]));
+            store(bot + 2 * x,     _mm_unpacklo_epi32(out[1][0], out[1][1]));
+            store(bot + 2 * x + 4, _mm_unpackhi_epi32(out[1][0], out[1][1]));
+        }
+#endif
+        for (; x < width_; x++) {
+            const std::size_t e0     = rowStart + std::size_t(x);
+            std::uint32_t     E      = padded_[e0];
+            std::uint32_t    *out[2] = { top + 2 * x, bot + 2 * x };
+            out[0][0] = out[0][1] = out[1][0] = out[1][1] = E;
+
+            for (const Corner &k : corners) {
+                const std::uint32_t F = padded_[e0 + k.off[pF]], H = padded_[e0 + k.off[pH]];
+                if (E == F || E == H) continue;
+
+                int d[PairCount];
+                for (int q = 0; q < PairCount; q++) d[q] = k.plane[q][long(e0) + k.planeOff[q]];
+
+                int across = d[EC] + d[EG] + d[IH5] + d[IF4] + 4 * d[HF];
+                int along  = d[HD] + d[HI5] + d[FI4] + d[FB] + 4 * d[EI];
+                bool edge = across < along
+                         && ((d[FB] >= Same && d[HD] >= Same)
+                             || (d[EI] < Same && d[FI4] >= Same && d[HI5] >= Same)
+                             || d[EG] < Same || d[EC] < Same);
+                if (!edge) continue;
+
+                const std::uint32_t B = padded_[e0 + k.off[pB]], C = padded_[e0 + k.off[pC]],
+                                    D = padded_[e0 + k.off[pD]], G = padded_[e0 + k.off[pG]];
+                const bool          shallow = 2 * d[FG] <= d[HC] && E != G && D != G;
+                const bool          steep   = d[FG] >= 2 * d[HC] && E != C && B != C;
+                const std::uint32_t px      = d[EF] <= d[EH] ? F : H;
+
+                std::uint32_t &n3 = out[k.cy][k.cx];      // the corner itself
+                std::uint32_t &n2 = out[k.cy][1 - k.cx];  // beside it (shallow edges)
+                std::uint32_t &n1 = out[1 - k.cy][k.cx];  // above/below it (steep edges)
+                if (shallow && steep) { n3 = blend(n3, px, 224); n2 = blend(n2, px, 64); n1 = n2; }
+                else if (shallow)     { n3 = blend(n3, px, 192); n2 = blend(n2, px, 64); }
+                else if (steep)       { n3 = blend(n3, px, 192); n1 = blend(n1, px, 64); }
+                else                  { n3 = blend(n3, px, 128); }
+            }
+        }
+    }
+}
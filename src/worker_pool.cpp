@@ -0,0 +1,41 @@
+// worker_pool.cpp
+#include "worker_pool.hpp"
+#include "profiler.hpp"
+
+WorkerPool::WorkerPool(unsigned int threads)
+{
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1; // unknown core count
+
+    threads_.reserve(threads);
+    for (unsigned int i = 0; i < threads; i++) {
+        threads_.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &t : threads_) t.join();
+}
+
+void WorkerPool::workerLoop()
+{
+    PROFILE_THREAD("worker");
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) return; // stopping and drained
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        PROFILE_ZONE("WorkerPool::job");
+        job();
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef _WORKER_POOL_H_
+#define _WORKER_POOL_H_
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// WorkerPool: fixed set of threads draining a FIFO job queue.
+//
+// Used for CPU-only work (asset decoding at startup). Jobs must not touch the
+// GPU or audio device; hand their results back through the returned future
+// and do that part on the main thread.
+//------------------------------------------------------------------------------
+class WorkerPool {
+public:
+    /// `threads` = 0 → one per hardware thread
+    explicit WorkerPool(unsigned int threads = 0);
+
+    /// Finishes every queued job, then joins the threads
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// Queue `job`; its result (or exception) arrives through the future
+    template <class F>
+    auto submit(F &&job) -> std::future<decltype(job())>
+    {
+        using Result = decltype(job());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.emplace_back([task] { (*task)(); });
+        }
+        wake_.notify_one();
+        return result;
+    }
+
+    inline unsigned int size() const { return unsigned(threads_.size()); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread>          threads_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex                        mutex_;
+    std::condition_variable           wake_;
+    bool                              stopping_ = false;
+};
+
+#endif
@@ -0,0 +1,179 @@
+// asset_packer.cpp
+//
+// Offline asset archive builder, run at build time:
+//     kungfu_pack <assets dir> <output file> [atlas dir] [tiles dir]
+//
+// Writes kungfu.pak (see asset_archive.hpp) containing only the assets named
+// in spritesList / soundsList / musicsList. Images are decoded to RGBA8 and
+// sound effects to raw PCM here, once, instead of on every game start.
+// Music is copied as-is (it is streamed, decoding it up front would cost
+// tens of MB). If an atlas dir is given, its pages and atlas.idx are packed
+// instead of the individual sprite images. .tmap files in a tiles dir
+// (tools/tile_converter.cpp) are packed as blobs named tiles/<background>.
+
+#include <raylib.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "asset_ids.hpp"
+#include "asset_archive.hpp"
+#include "atlas_handler.hpp"
+#include "tile_map.hpp"
+
+using std::string;
+using std::vector;
+
+namespace {
+    struct PendingEntry {
+        ArchiveEntry          entry{};
+        vector<unsigned char> payload;
+    };
+
+    PendingEntry makeEntry(const string &name, ArchiveEntryType type, const void *data, size_t size)
+    {
+        PendingEntry p;
+        std::strncpy(p.entry.name, name.c_str(), ArchiveNameSize - 1);
+        p.entry.type = type;
+        p.entry.size = std::uint32_t(size);
+        const auto *bytes = static_cast<const unsigned char*>(data);
+        p.payload.assign(bytes, bytes + size);
+        return p;
+    }
+
+    bool addImage(vector<PendingEntry> &out, const string &name, const string &path)
+    {
+        Image img = LoadImage(path.c_str());
+        if (img.data == nullptr) return false;
+        ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+        out.push_back(makeEntry(name, ArchiveEntryType::Image, img.data,
+                                size_t(img.width) * img.height * 4));
+        out.back().entry.params[0] = std::uint32_t(img.width);
+        out.back().entry.params[1] = std::uint32_t(img.height);
+        UnloadImage(img);
+        return true;
+    }
+
+    bool addWave(vector<PendingEntry> &out, const string &name, const string &path)
+    {
+        Wave wave = LoadWave(path.c_str());
+        if (wave.data == nullptr) return false;
+
+        out.push_back(makeEntry(name, ArchiveEntryType::Wave, wave.data,
+                                size_t(wave.frameCount) * wave.channels * (wave.sampleSize / 8)));
+        out.back().entry.params[0] = wave.frameCount;
+        out.back().entry.params[1] = wave.sampleRate;
+        out.back().entry.params[2] = wave.sampleSize;
+        out.back().entry.params[3] = wave.channels;
+        UnloadWave(wave);
+        return true;
+    }
+
+    bool addBlob(vector<PendingEntry> &out, const string &name, const string &path)
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs) return false;
+        vector<unsigned char> bytes((std::istreambuf_iterator<char>(ifs)),
+                                    std::istreambuf_iterator<char>());
+        out.push_back(makeEntry(name, ArchiveEntryType::Blob, bytes.data(), bytes.size()));
+        return true;
+    }
+
+    inline std::uint32_t alignUp(std::uint32_t v) {
+        return (v + ArchiveAlignment - 1) & ~(ArchiveAlignment - 1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3 || argc > 5) {
+        std::fprintf(stderr, "usage: %s <assets dir> <output file> [atlas dir] [tiles dir]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const string assetsDir = string(argv[1]) + "/";
+    const string outFile   = argv[2];
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    vector<PendingEntry> entries;
+    auto fail = [](const string &what) {
+        std::fprintf(stderr, "pack: cannot load %s\n", what.c_str());
+        return EXIT_FAILURE;
+    };
+
+    // ----------------------------------------------------------------------
+    // Sprites: atlas pages + region table if available, else loose images
+    // ----------------------------------------------------------------------
+    SpriteAtlas atlas;
+    if (argc >= 4 && atlas.load(string(argv[3]) + "/")) {
+        const string atlasDir = string(argv[3]) + "/";
+        for (const auto &page : atlas.pages) {
+            if (!addImage(entries, "atlas/" + page, atlasDir + page)) return fail(page);
+        }
+        std::ostringstream idx;
+        atlas.write(idx);
+        const string table = idx.str();
+        entries.push_back(makeEntry(string("atlas/") + SpriteAtlas::IndexFile,
+                                    ArchiveEntryType::Blob, table.data(), table.size()));
+    }
+    else {
+        for (const char *name : spritesList) {
+            if (!addImage(entries, string("images/") + name,
+                          assetsDir + "images/" + name + ".png")) return fail(name);
+        }
+    }
+
+    for (const char *name : soundsList) {
+        if (!addWave(entries, string("sounds/") + name,
+                     assetsDir + "sounds/" + name + ".wav")) return fail(name);
+    }
+    for (const char *name : musicsList) {
+        if (!addBlob(entries, string("musics/") + name,
+                     assetsDir + "musics/" + name + ".mp3")) return fail(name);
+    }
+
+    // Tiled backgrounds, loaded with TileMap::parse straight from the mapping
+    if (argc == 5) {
+        for (const auto &file : std::filesystem::directory_iterator(argv[4])) {
+            if (file.path().extension() != TileMapExtension) continue;
+            if (!addBlob(entries, "tiles/" + file.path().stem().string(), file.path().string()))
+                return fail(file.path().string());
+        }
+    }
+
+    // ----------------------------------------------------------------------
+    // Lay out: header, index, then aligned payloads
+    // ----------------------------------------------------------------------
+    ArchiveHeader header = { ArchiveMagic, ArchiveVersion, std::uint32_t(entries.size()), 0 };
+    std::uint32_t offset = alignUp(std::uint32_t(sizeof(ArchiveHeader)
+                                                 + entries.size() * sizeof(ArchiveEntry)));
+    for (auto &p : entries) {
+        p.entry.offset = offset;
+        offset = alignUp(offset + p.entry.size);
+    }
+
+    vector<unsigned char> file(offset, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    for (size_t i = 0; i < entries.size(); i++) {
+        std::memcpy(&file[sizeof(ArchiveHeader) + i * sizeof(ArchiveEntry)],
+                    &entries[i].entry, sizeof(ArchiveEntry));
+        std::memcpy(&file[entries[i].entry.offset], entries[i].payload.data(), entries[i].payload.size());
+    }
+
+    std::ofstream ofs(outFile, std::ios::binary);
+    if (!ofs.write(reinterpret_cast<const char*>(file.data()), std::streamsize(file.size()))) {
+        std::fprintf(stderr, "pack: cannot write %s\n", outFile.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("pack: %zu entries, %u bytes\n", entries.size(), offset);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+// atlas_packer.cpp
+//
+// Offline sprite atlas packer, run at build time:
+//     kungfu_atlas <images dir> <output dir>
+//
+// Packs every sprite in spritesList (and nothing else) into as few
+// PageWidth x PageHeight pages as possible, writes them as atlas_<n>.png and
+// records where each sprite landed in atlas.idx (see atlas_handler.hpp).
+// Each enemy's sheets get pages of their own, so EnemyResidency can load
+// and evict them per level.
+
+#include <raylib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "asset_ids.hpp"
+#include "atlas_handler.hpp"
+
+using std::string;
+using std::vector;
+
+//------------------------------------------------------------------------------
+// Packing parameters
+//------------------------------------------------------------------------------
+constexpr int PageWidth   = 1024;
+constexpr int PageHeight  = 1024;
+constexpr int PagePadding = 1;    ///< transparent gap so neighbours never bleed
+
+namespace {
+    struct Page {
+        vector<unsigned char> pixels = vector<unsigned char>(PageWidth * PageHeight * 4, 0);
+        int usedWidth  = 0;  ///< pages are cropped to these when written
+        int usedHeight = 0;
+    };
+
+    // Shelf packer state: current row on the current page
+    struct Shelf {
+        int page = 0, x = 0, y = 0, height = 0;
+    };
+
+    void blit(Page &page, const Image &img, int dstX, int dstY)
+    {
+        const auto *src = static_cast<const unsigned char*>(img.data);
+        for (int row = 0; row < img.height; row++) {
+            std::memcpy(&page.pixels[((dstY + row) * PageWidth + dstX) * 4],
+                        &src[row * img.width * 4], size_t(img.width) * 4);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <images dir> <output dir>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const string imagesDir = string(argv[1]) + "/";
+    const string outDir    = string(argv[2]) + "/";
+
+    // ----------------------------------------------------------------------
+    // Decode every referenced sprite as RGBA8
+    // ----------------------------------------------------------------------
+    vector<Image> images(SpriteCount);
+    for (size_t i = 0; i < SpriteCount; i++) {
+        images[i] = LoadImage((imagesDir + spritesList[i] + ".png").c_str());
+        if (images[i].data == nullptr) {
+            std::fprintf(stderr, "atlas: cannot load %s.png\n", spritesList[i]);
+            return EXIT_FAILURE;
+        }
+        if (images[i].width > PageWidth || images[i].height > PageHeight) {
+            std::fprintf(stderr, "atlas: %s.png does not fit on a page\n", spritesList[i]);
+            return EXIT_FAILURE;
+        }
+        ImageFormat(&images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    }
+
+    // ----------------------------------------------------------------------
+    // Shelf packing: shared sprites first, then one group per enemy; tallest
+    // first inside a group (keeps rows tight for same-height sheets)
+    // ----------------------------------------------------------------------
+    vector<size_t> order(SpriteCount);
+    for (size_t i = 0; i < SpriteCount; i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        int groupA = enemyOfSprite(SpriteId(a)), groupB = enemyOfSprite(SpriteId(b));
+        if (groupA != groupB) return groupA < groupB;
+        if (images[a].height != images[b].height) return images[a].height > images[b].height;
+        return images[a].width > images[b].width;
+    });
+
+    SpriteAtlas  atlas;
+    vector<Page> pages(1);
+    Shelf        shelf;
+
+    int group = enemyOfSprite(SpriteId(order[0]));
+
+    for (size_t i : order) {
+        const Image &img = images[i];
+
+        if (enemyOfSprite(SpriteId(i)) != group) {     // new group → new page
+            group = enemyOfSprite(SpriteId(i));
+            pages.emplace_back();
+            shelf = { shelf.page + 1, 0, 0, 0 };
+        }
+        if (shelf.x + img.width > PageWidth) {          // row full → next row
+            shelf.y     += shelf.height + PagePadding;
+            shelf.x      = 0;
+            shelf.height = 0;
+        }
+        if (shelf.y + img.height > PageHeight) {        // page full → next page
+            pages.emplace_back();
+            shelf = { shelf.page + 1, 0, 0, 0 };
+        }
+
+        blit(pages[shelf.page], img, shelf.x, shelf.y);
+        atlas.regions[i] = { shelf.page,
+                             { float(shelf.x), float(shelf.y), float(img.width), float(img.height) },
+                             spriteFrameCounts[i] };
+
+        shelf.x      += img.width + PagePadding;
+        shelf.height  = std::max(shelf.height, img.height);
+        pages[shelf.page].usedWidth  = std::max(pages[shelf.page].usedWidth,  shelf.x - PagePadding);
+        pages[shelf.page].usedHeight = std::max(pages[shelf.page].usedHeight, shelf.y + img.height);
+    }
+
+    // ----------------------------------------------------------------------
+    // Write pages (cropped to the used area) and the region table
+    // ----------------------------------------------------------------------
+    for (size_t p = 0; p < pages.size(); p++) {
+        string file = "atlas_" + std::to_string(p) + ".png";
+        Image full = { pages[p].pixels.data(), PageWidth, PageHeight, 1,
+                       PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        Image page = ImageFromImage(full, { 0, 0, float(pages[p].usedWidth), float(pages[p].usedHeight) });
+        bool written = ExportImage(page, (outDir + file).c_str());
+        UnloadImage(page);
+        if (!written) {
+            std::fprintf(stderr, "atlas: cannot write %s\n", file.c_str());
+            return EXIT_FAILURE;
+        }
+        atlas.pages.push_back(file);
+    }
+
+    for (auto &img : images) UnloadImage(img);
+
+    if (!atlas.save(outDir)) {
+        std::fprintf(stderr, "atlas: cannot write %s\n", SpriteAtlas::IndexFile);
+        return EXIT_FAILURE;
+    }
+
+    std::printf("atlas: packed %zu sprites into %zu page(s)\n", SpriteCount, pages.size());
+    return EXIT_SUCCESS;
+}
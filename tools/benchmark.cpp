@@ -0,0 +1,489 @@
+// benchmark.cpp
+//
+// Microbenchmarks for the per-tick hot paths, headless (NullPlatform):
+//     kungfu_bench [--json <file>] [--filter <substring>] [--min-ms <n>] [--replay <file>]
+//
+// Run from the build directory (it loads assets/ like the game). Prints a
+// table with ns/op and heap allocations/op; --json also writes the results
+// in a stable machine-readable form for tracking regressions across releases.
+// Game::step is driven by the given replay, or by a scripted input pattern.
+// The CPU backend's blits, the present upscalers and the hit sparks' draws run
+// on SoftwarePlatform.
+//
+// Before timing anything it checks that versus over a lossy loopback stays in
+// sync and, with --replay, that a seek renders like playback; exits 1 if not.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "game_handler.hpp"
+#include "net_transport.hpp"
+#include "player_handler.hpp"
+#include "state_handler.hpp"
+#include "software_platform.hpp"
+#include "particle_system.hpp"
+#include "rollback_session.hpp"
+#include "upscaler.hpp"
+
+using std::string;
+using std::vector;
+
+//------------------------------------------------------------------------------
+// Allocation counting: every global operator new in this process goes through
+// here. Only the benchmarked loop runs while counting, so the totals are its own.
+//------------------------------------------------------------------------------
+namespace {
+    std::atomic<std::uint64_t> allocCount{0};
+    std::atomic<std::uint64_t> allocBytes{0};
+
+    void* countedAlloc(std::size_t size)
+    {
+        allocCount.fetch_add(1, std::memory_order_relaxed);
+        allocBytes.fetch_add(size, std::memory_order_relaxed);
+        if (void *p = std::malloc(size ? size : 1)) return p;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size)                 { return countedAlloc(size); }
+void* operator new[](std::size_t size)               { return countedAlloc(size); }
+void  operator delete(void *p) noexcept              { std::free(p); }
+void  operator delete[](void *p) noexcept            { std::free(p); }
+void  operator delete(void *p, std::size_t) noexcept   { std::free(p); }
+void  operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+    //--------------------------------------------------------------------------
+    // Harness
+    //--------------------------------------------------------------------------
+    struct BenchResult {
+        string        name;
+        std::uint64_t iterations;
+        double        nsPerOp;
+        double        allocsPerOp;
+        double        bytesPerOp;
+    };
+
+    /// Results are folded in here so the compiler cannot drop the work
+    volatile long long sink = 0;
+    inline void keep(long long value) { sink = sink + value; }
+
+    struct Bench {
+        string                                    name;
+        std::function<void(std::uint64_t)>        run;   ///< performs n operations
+    };
+
+    /// Double the iteration count until one run takes at least `minMs`, report that run
+    BenchResult measure(const Bench &bench, double minMs)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        bench.run(16); // warm caches, grow recording buffers
+
+        for (std::uint64_t n = 64;; n *= 2) {
+            std::uint64_t allocs0 = allocCount.load(), bytes0 = allocBytes.load();
+            auto t0 = Clock::now();
+            bench.run(n);
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+            std::uint64_t allocs = allocCount.load() - allocs0, bytes = allocBytes.load() - bytes0;
+
+            if (ns >= minMs * 1e6 || n >= (std::uint64_t(1) << 40)) {
+                return { bench.name, n, ns / double(n), double(allocs) / double(n),
+                         double(bytes) / double(n) };
+            }
+        }
+    }
+
+    bool writeJson(const string &path, const vector<BenchResult> &results)
+    {
+        std::FILE *f = std::fopen(path.c_str(), "w");
+        if (f == nullptr) return false;
+
+        std::fprintf(f, "{\n  \"suite\": \"kungfu_bench\",\n  \"version\": \"%s\",\n  \"results\": [\n", VERSION);
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const BenchResult &r = results[i];
+            std::fprintf(f, "    { \"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                            "\"allocs_per_op\": %.4f, \"bytes_per_op\": %.2f }%s\n",
+                         r.name.c_str(), (unsigned long long)r.iterations, r.nsPerOp,
+                         r.allocsPerOp, r.bytesPerOp, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+
+    /// Scripted stand-in for a recorded session: start the game, then walk,
+    /// punch and kick in a fixed pattern
+    template <class Backend>
+    void scriptedInput(Backend &platform, std::uint64_t tick)
+    {
+        platform.setKeyDown(Key::Enter, tick % 600 > 5 && tick % 600 < 10);
+        platform.setKeyDown(Key::A,     (tick / 7) % 2);
+        platform.setKeyDown(Key::S,     (tick / 11) % 3 == 0);
+        platform.setKeyDown(Key::Right, (tick / 50) % 3 == 0);
+    }
+
+    /// Pixels that differ between tick `tick` of `replayPath` played straight
+    /// and the same tick reached by Game::seekReplay in a fresh Game (which
+    /// never ran PlayState::init), both rendered by SoftwarePlatform.
+    /// Sparks are cleared first: they are cosmetic and not in keyframes.
+    long seekFrameDifference(const string &replayPath, std::uint32_t tick)
+    {
+        SoftwarePlatform straightPlatform, seekPlatform;
+        Game straight(straightPlatform), seeked(seekPlatform);
+        if (!straight.playReplay(replayPath) || !seeked.playReplay(replayPath) || !seeked.seekReplay(tick))
+            return -1;
+        for (std::uint32_t t = 0; t < tick; t++) straight.tick();
+
+        straight.playState->particles.clear();
+        seeked.playState->particles.clear();
+        straight.step();
+        seeked.step();
+
+        long differing = 0;
+        for (std::size_t p = 0; p < std::size_t(GAME_WIDTH) * GAME_HEIGHT; p++)
+            differing += straightPlatform.framebuffer()[p] != seekPlatform.framebuffer()[p];
+        return differing;
+    }
+
+    /// Versus between two Games in this process: LoopbackTransport, with each
+    /// side's packets delayed, reordered and dropped by SimulatedNetwork
+    /// (`conditions` as in --netsim), both players on scripted keys for
+    /// `ticks` steps. The first desynced frame, -1 if none, -2 if the
+    /// sessions never connected.
+    int loopbackVersusDesync(const char *conditions, std::uint64_t ticks)
+    {
+        NetConditions net;
+        if (!parseNetConditions(conditions, net)) return -2;
+
+        NullPlatform      hostPlatform, guestPlatform;
+        Game              host(hostPlatform), guest(guestPlatform);
+        LoopbackTransport hostEnd, guestEnd;
+        LoopbackTransport::link(hostEnd, guestEnd);
+        SimulatedNetwork  hostLink(hostEnd, net, 1), guestLink(guestEnd, net, 2);
+        RollbackSession   hostSession(host, hostLink, 0), guestSession(guest, guestLink, 1);
+        host.setNetplay(&hostSession);
+        guest.setNetplay(&guestSession);
+
+        for (std::uint64_t t = 0; t < ticks; t++) {
+            scriptedInput(hostPlatform, t);
+            scriptedInput(guestPlatform, t * 3 + 17);  // another rhythm for the enemy
+            host.step();
+            guest.step();
+        }
+        host.setNetplay(nullptr);
+        guest.setNetplay(nullptr);
+
+        if (!hostSession.isConnected() || !guestSession.isConnected()) return -2;
+        const int hostDesync = hostSession.stats().desyncFrame, guestDesync = guestSession.stats().desyncFrame;
+        return hostDesync >= 0 && guestDesync >= 0 ? std::min(hostDesync, guestDesync)
+                                                   : std::max(hostDesync, guestDesync);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    string jsonPath, filter, replayPath;
+    double minMs = 200;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if      (hasValue && std::strcmp(argv[i], "--json") == 0)   jsonPath   = argv[++i];
+        else if (hasValue && std::strcmp(argv[i], "--filter") == 0) filter     = argv[++i];
+        else if (hasValue && std::strcmp(argv[i], "--min-ms") == 0) minMs      = std::atof(argv[++i]);
+        else if (hasValue && std::strcmp(argv[i], "--replay") == 0) replayPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: %s [--json <file>] [--filter <substring>] "
+                                 "[--min-ms <n>] [--replay <file>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // --------------------------------------------------------------------------
+    // Fixture: a game in PlayState (level 1), fixed seed
+    // --------------------------------------------------------------------------
+    NullPlatform platform;
+    Game game(platform);
+    game.seed = 1;
+    game.rng.seed(game.seed);
+
+    for (std::uint64_t t = 0; t < 2000 && game.state != GameState::Play; t++) {
+        scriptedInput(platform, t);
+        game.step();
+    }
+    for (Key key : { Key::Enter, Key::A, Key::S, Key::Right }) platform.setKeyDown(key, false);
+    game.step();
+    if (game.state != GameState::Play) {
+        std::fprintf(stderr, "bench: could not reach PlayState\n");
+        return EXIT_FAILURE;
+    }
+
+    PlayState &play   = *game.playState;
+    Player    &player = *game.player;
+    const int  enemyStartX = play.enemyX;
+
+    // Sprite drawn straight into the null renderer: 8 frames of 32x32
+    NullPlatform nullRenderer;
+    Sprite sheet(nullRenderer, TextureHandle{ 1, 256, 32 }, Rect{ 0, 0, 256, 32 });
+    sheet.setFrameCount(8);
+    sheet.setAnimationSpeed(EnemyWalkSpriteFPS);
+    SpriteAnim anim;
+
+    // CPU backend blits: a 64x64 sprite, every other pixel transparent
+    SoftwarePlatform cpu;
+    vector<unsigned char> checker(64 * 64 * 4, 0xFF);
+    for (std::size_t p = 0; p < checker.size() / 4; p++) checker[p * 4 + 3] = (p & 1) ? 0xFF : 0;
+    TextureHandle blitSprite = cpu.loadTextureFromPixels(64, 64, checker.data());
+
+    // A play-screen frame rendered by the CPU backend, for the upscalers
+    SoftwarePlatform frameSource;
+    Game             frameGame(frameSource);
+    frameGame.seed = 1;
+    frameGame.rng.seed(frameGame.seed);
+    for (std::uint64_t t = 0; t < 2000 && (frameGame.state != GameState::Play || t < 600); t++) {
+        scriptedInput(frameSource, t);
+        frameGame.step();
+    }
+    vector<std::uint32_t> frame(frameSource.framebuffer(),
+                                frameSource.framebuffer() + std::size_t(GAME_WIDTH) * GAME_HEIGHT);
+    Upscaler upscaler;
+
+    // Sparks kept at a few thousand live: bursts refill what burnt out
+    constexpr std::size_t liveSparks = 4096;
+    ParticleSystem sparks(liveSparks);
+    auto refillSparks = [&] {
+        while (sparks.size() < liveSparks) sparks.burst(128, 120, 64, 0);
+    };
+
+    // Rollback has to reproduce the peer's simulation, or its cost below means nothing
+    for (const char *conditions : { "150/80/20", "30/100/40" }) {
+        const int desync = loopbackVersusDesync(conditions, 6000);
+        if (desync != -1) {
+            if (desync == -2) std::fprintf(stderr, "bench: loopback versus at %s never connected\n", conditions);
+            else              std::fprintf(stderr, "bench: loopback versus at %s desynced at frame %d\n", conditions, desync);
+            return EXIT_FAILURE;
+        }
+    }
+
+    SimSnapshot snapshot{};
+    vector<SimSnapshot> rollbackFrames(NETPLAY_MAX_ROLLBACK);  // what RollbackSession keeps per frame
+
+    // Draws through Game::platform are recorded by the FramePacer; start a new
+    // recording every so often so the buffer stays at one tick's worth
+    auto recordedDraws = [&](std::uint64_t n, auto &&draw) {
+        for (std::uint64_t i = 0; i < n; i++) {
+            if ((i & 255) == 0) game.platform.beginFrame();
+            draw();
+        }
+    };
+
+    // --------------------------------------------------------------------------
+    // Benchmarks
+    // --------------------------------------------------------------------------
+    vector<Bench> benches = {
+        { "Sprite::updateAndDraw", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                anim.flipped = (i & 64) != 0;
+                keep(sheet.updateAndDraw(anim));
+            }
+        } },
+        { "Sprite::drawFrame", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) sheet.drawFrame(int(i & 7), int(i & 127), 96);
+        } },
+        { "SoftwarePlatform::drawTexture", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++)
+                cpu.drawTexture(blitSprite, { 0, 0, 64, 64 }, float(i & 127), 96, DrawLayer::Player);
+        } },
+        { "SoftwarePlatform::drawTexture mirrored", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++)
+                cpu.drawTexture(blitSprite, { 0, 0, -64, 64 }, float(i & 127), 96, DrawLayer::Player);
+        } },
+        { "Upscaler nearest x3 (frame)", [&](std::uint64_t n) {
+            upscaler.setFilter(UpscaleFilter::Nearest, 3);
+            for (std::uint64_t i = 0; i < n; i++) upscaler.run(frame.data(), GAME_WIDTH, GAME_HEIGHT);
+        } },
+        { "Upscaler scale2x (frame)", [&](std::uint64_t n) {
+            upscaler.setFilter(UpscaleFilter::Scale2x);
+            for (std::uint64_t i = 0; i < n; i++) upscaler.run(frame.data(), GAME_WIDTH, GAME_HEIGHT);
+        } },
+        { "Upscaler scale3x (frame)", [&](std::uint64_t n) {
+            upscaler.setFilter(UpscaleFilter::Scale3x);
+            for (std::uint64_t i = 0; i < n; i++) upscaler.run(frame.data(), GAME_WIDTH, GAME_HEIGHT);
+        } },
+        { "Upscaler xbr (frame)", [&](std::uint64_t n) {
+            upscaler.setFilter(UpscaleFilter::Xbr2x);
+            for (std::uint64_t i = 0; i < n; i++) upscaler.run(frame.data(), GAME_WIDTH, GAME_HEIGHT);
+        } },
+        { "ParticleSystem update+respawn (4096 live)", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                refillSparks();
+                sparks.update();
+            }
+        } },
+        { "ParticleSystem::draw (4096 live, software)", [&](std::uint64_t n) {
+            refillSparks();
+            for (std::uint64_t i = 0; i < n; i++) sparks.draw(cpu);
+        } },
+        { "State::drawText", [&](std::uint64_t n) {
+            recordedDraws(n, [&] { play.drawText("score 012300", 8, 8); });
+        } },
+        { "State::drawNumber", [&](std::uint64_t n) {
+            recordedDraws(n, [&] { play.drawNumber(12300, 8, 8); });
+        } },
+        { "PlayState::isCollidedWithPlayer", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                play.enemyCurrentMove = (i & 1) ? EnemyAction::Kick : EnemyAction::Punch;
+                play.enemyX = player.x + int(i & 31);
+                keep(play.isCollidedWithPlayer());
+            }
+        } },
+        { "Player::processCollision", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                player.currAction_ = (i & 1) ? PlayerAction::KickStand : PlayerAction::PunchStand;
+                play.enemyX = player.x + int(i & 63);
+                player.processCollision();
+            }
+        } },
+        { "PlayState::updateEnemyMovementState", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                if ((i & 63) == 0) { // chase from the start position again
+                    play.enemyMoveState = MoveState::FollowPlayer;
+                    play.enemyX = enemyStartX;
+                }
+                play.updateEnemyMovementState();
+            }
+        } },
+        { "Game::capture (SimSnapshot)", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                game.capture(snapshot);
+                keep(snapshot.score);
+            }
+        } },
+        { "Game::restore (SimSnapshot)", [&](std::uint64_t n) {
+            game.capture(snapshot);
+            for (std::uint64_t i = 0; i < n; i++) keep(game.restore(snapshot));
+        } },
+        { "checksum(SimSnapshot)", [&](std::uint64_t n) {
+            game.capture(snapshot);
+            for (std::uint64_t i = 0; i < n; i++) keep((long long)checksum(snapshot));
+        } },
+        { "Rollback (restore + 8 muted ticks)", [&](std::uint64_t n) {
+            // Worst case RollbackSession corrects within one tick: back to the
+            // oldest predicted frame, then every frame again, snapshotting each
+            game.capture(snapshot);
+            InputSnapshot hero, enemy;
+            hero.set(Key::A, true, false);
+            enemy.set(Key::Left, true, false);
+            game.muteOutput(Mute::Draws | Mute::Sounds);
+            for (std::uint64_t i = 0; i < n; i++) {
+                game.restore(snapshot);
+                for (SimSnapshot &frame : rollbackFrames) {
+                    game.capture(frame);
+                    game.advance(hero, enemy);
+                }
+                keep(game.playState->enemyX);
+            }
+            game.muteOutput(Mute::None);
+            game.restore(snapshot);
+        } },
+        { "Game::sprite/sound lookup", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                keep(game.sprite(SpriteId(i % SpriteCount)).getWidth());
+                keep(game.sound(SoundId(i % SoundCount)).id);
+            }
+        } },
+    };
+
+    // Whole ticks last: they advance the game state the fixtures above rely on
+    Game *stepGame = &game;
+    NullPlatform replayPlatform;
+    std::unique_ptr<Game> replayGame;
+    if (!replayPath.empty()) {
+        replayGame = std::make_unique<Game>(replayPlatform);
+        if (!replayGame->playReplay(replayPath)) {
+            std::fprintf(stderr, "bench: cannot read replay %s\n", replayPath.c_str());
+            return EXIT_FAILURE;
+        }
+        stepGame = replayGame.get();
+
+        // A seek has to look like playback, or its timing below means nothing
+        const Replay &replay = replayGame->replay;
+        for (std::uint32_t k = 0; k < replay.keyframeCount(); k += std::max(1u, replay.keyframeCount() / 4)) {
+            const std::uint32_t tick = std::min((k + 1) * replay.keyframeInterval() - 1, replay.tickCount() - 1);
+            const long differing = seekFrameDifference(replayPath, tick);
+            if (differing != 0) {
+                std::fprintf(stderr, "bench: tick %u after a seek differs from playback (%ld pixels)\n",
+                             tick, differing);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    std::uint64_t scriptTick = 0;
+    benches.push_back({ "Game::step", [&](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; i++) {
+            if (!replayGame) scriptedInput(platform, scriptTick++);
+            stepGame->step();
+        }
+    } });
+    // Run-ahead simulates 1 + frames ticks per step and snapshots twice;
+    // all of it has to fit one 16.6 ms display frame
+    for (int frames : { 1, 2, 4, Game::MaxRunAhead }) {
+        benches.push_back({ "Game::step (run-ahead " + std::to_string(frames) + ")", [&, frames](std::uint64_t n) {
+            stepGame->setRunAhead(frames);
+            for (std::uint64_t i = 0; i < n; i++) {
+                if (!replayGame) scriptedInput(platform, scriptTick++);
+                stepGame->step();
+            }
+            stepGame->setRunAhead(0);
+        } });
+    }
+    // Worst-case seek: one tick before the next keyframe (files with keyframes only)
+    if (replayGame && replayGame->replay.keyframeCount() > 0) {
+        benches.push_back({ "Game::seekReplay (worst case)", [&](std::uint64_t n) {
+            const Replay &replay = replayGame->replay;
+            for (std::uint64_t i = 0; i < n; i++) {
+                const std::uint32_t key = std::uint32_t(i % replay.keyframeCount());
+                replayGame->seekReplay(std::min((key + 1) * replay.keyframeInterval() - 1, replay.tickCount()));
+                keep(replayGame->score);
+            }
+        } });
+    }
+    // Rewind history on the scripted game (replays turn rewind off): every
+    // tick is pushed, and every other 60 ticks are popped and shown again.
+    // Left on once set (last bench), so the history's storage is reused.
+    benches.push_back({ "Game::step (rewind: 60 on, 60 back)", [&](std::uint64_t n) {
+        if (game.rewindHistory().capacity() == 0) game.setRewind();
+        for (std::uint64_t i = 0; i < n; i++) {
+            const bool back = (i / 60) % 2 == 1;
+            platform.setDebugKeyDown(DebugKey::Rewind, back);
+            if (!back) scriptedInput(platform, scriptTick++);
+            game.step();
+        }
+        platform.setDebugKeyDown(DebugKey::Rewind, false);
+        keep((long long)game.rewindHistory().bytes());
+    } });
+
+    vector<BenchResult> results;
+    std::printf("%-40s %12s %12s %12s %10s\n", "benchmark", "iterations", "ns/op", "allocs/op", "B/op");
+    for (const Bench &bench : benches) {
+        if (!filter.empty() && bench.name.find(filter) == string::npos) continue;
+        results.push_back(measure(bench, minMs));
+        const BenchResult &r = results.back();
+        std::printf("%-40s %12llu %12.2f %12.4f %10.1f\n", r.name.c_str(),
+                    (unsigned long long)r.iterations, r.nsPerOp, r.allocsPerOp, r.bytesPerOp);
+    }
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, results)) {
+        std::fprintf(stderr, "bench: cannot write %s\n", jsonPath.c_str());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+// tile_converter.cpp
+//
+// Offline background tiler, run at build time:
+//     kungfu_tiles <output dir> <image.png>...
+//
+// Cuts each background into TileSize x TileSize tiles, keeps one copy of
+// every tile that appears more than once (as is, mirrored, or upside down)
+// and writes <output dir>/<image name>.tmap (see tile_map.hpp). Images whose
+// size is not a multiple of TileSize are padded with transparent pixels.
+// Needs no raylib: PNGs go through the software backend's decoder.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "png_decoder.hpp"
+#include "tile_map.hpp"
+
+using std::string;
+using std::vector;
+
+namespace {
+    constexpr int TilePixels = TileSize * TileSize;
+
+    /// One tile's RGBA8 bytes, row after row; also the dedup key
+    using Tile = string;
+
+    Tile cutTile(const PixelImage &img, int col, int row)
+    {
+        Tile tile(std::size_t(TilePixels) * 4, '\0');  // outside the image: transparent
+        for (int y = 0; y < TileSize; y++) {
+            const int sy = row * TileSize + y;
+            if (sy >= img.height) break;
+            for (int x = 0; x < TileSize; x++) {
+                const int sx = col * TileSize + x;
+                if (sx >= img.width) break;
+                std::memcpy(&tile[std::size_t(y * TileSize + x) * 4],
+                            &img.rgba[(std::size_t(sy) * img.width + sx) * 4], 4);
+            }
+        }
+        return tile;
+    }
+
+    /// The tile drawn with `flips` (TileMapEntry::FlipX / FlipY)
+    Tile transform(const Tile &tile, std::uint16_t flips)
+    {
+        Tile out(tile.size(), '\0');
+        for (int y = 0; y < TileSize; y++) {
+            const int sy = (flips & TileMapEntry::FlipY) ? TileSize - 1 - y : y;
+            for (int x = 0; x < TileSize; x++) {
+                const int sx = (flips & TileMapEntry::FlipX) ? TileSize - 1 - x : x;
+                std::memcpy(&out[std::size_t(y * TileSize + x) * 4], &tile[std::size_t(sy * TileSize + sx) * 4], 4);
+            }
+        }
+        return out;
+    }
+
+    string stem(const string &path)
+    {
+        const std::size_t slash = path.find_last_of("/\\");
+        string name = slash == string::npos ? path : path.substr(slash + 1);
+        const std::size_t dot = name.rfind('.');
+        return dot == string::npos ? name : name.substr(0, dot);
+    }
+
+    bool convert(const string &imagePath, const string &outDir)
+    {
+        PixelImage img;
+        if (!decodePngFile(imagePath, img)) {
+            std::fprintf(stderr, "tiles: cannot load %s\n", imagePath.c_str());
+            return false;
+        }
+
+        TileMapHeader header{};
+        header.magic   = TileMapMagic;
+        header.version = TileMapVersion;
+        header.width   = std::uint32_t(img.width);
+        header.height  = std::uint32_t(img.height);
+        header.columns = std::uint32_t((img.width  + TileSize - 1) / TileSize);
+        header.rows    = std::uint32_t((img.height + TileSize - 1) / TileSize);
+
+        // Try the tile as is first, so unflipped matches win
+        static constexpr std::uint16_t Variants[] = {
+            0, TileMapEntry::FlipX, TileMapEntry::FlipY, TileMapEntry::FlipX | TileMapEntry::FlipY
+        };
+
+        vector<Tile>                            tiles;
+        vector<std::uint16_t>                   cells;
+        std::unordered_map<Tile, std::uint16_t> seen;   ///< tile -> index in `tiles`
+        for (int row = 0; row < int(header.rows); row++) {
+            for (int col = 0; col < int(header.columns); col++) {
+                const Tile tile = cutTile(img, col, row);
+
+                // Drawing stored tile i with flips F gives F(tile i); every
+                // flip is its own inverse, so F(tile) == tile i means a match
+                bool found = false;
+                for (std::uint16_t flips : Variants) {
+                    auto it = seen.find(flips ? transform(tile, flips) : tile);
+                    if (it == seen.end()) continue;
+                    cells.push_back(std::uint16_t(it->second | flips));
+                    found = true;
+                    break;
+                }
+                if (found) continue;
+
+                if (tiles.size() >= TileMapEntry::MaxTiles) {
+                    std::fprintf(stderr, "tiles: %s has more than %u unique tiles\n",
+                                 imagePath.c_str(), TileMapEntry::MaxTiles);
+                    return false;
+                }
+                seen.emplace(tile, std::uint16_t(tiles.size()));
+                cells.push_back(std::uint16_t(tiles.size()));
+                tiles.push_back(tile);
+            }
+        }
+        header.tileCount = std::uint32_t(tiles.size());
+
+        const string outPath = outDir + "/" + stem(imagePath) + TileMapExtension;
+        std::ofstream ofs(outPath, std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ofs.write(reinterpret_cast<const char*>(cells.data()), std::streamsize(cells.size() * sizeof(std::uint16_t)));
+        for (const Tile &tile : tiles) ofs.write(tile.data(), std::streamsize(tile.size()));
+        if (!ofs) {
+            std::fprintf(stderr, "tiles: cannot write %s\n", outPath.c_str());
+            return false;
+        }
+
+        const std::size_t sourceBytes = std::size_t(img.width) * img.height * 4;
+        const std::size_t tiledBytes  = tiles.size() * TilePixels * 4 + cells.size() * sizeof(std::uint16_t);
+        std::printf("tiles: %s %dx%d, %zu cells -> %zu unique tiles, %zu -> %zu bytes (%.0f%%)\n",
+                    stem(imagePath).c_str(), img.width, img.height, cells.size(), tiles.size(),
+                    sourceBytes, tiledBytes, 100.0 * double(tiledBytes) / double(sourceBytes));
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <output dir> <image.png>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (int i = 2; i < argc; i++) {
+        if (!convert(argv[i], argv[1])) return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}